@@ -2,213 +2,249 @@
 #include "Pch.h"
 
 #include "Common.h"
+#include "MemoryProfile.h"
 #include "FindAddRemove.h"
+#include "SimdSearch.h"
+#include "Timer.h"
+#include "Statistics.h"
+#include "SlotStream.h"
+#include "RandomGenerators.h"
+#include "Distributions.h"
+#include "Trace.h"
+#include "PerfCounters.h"
+#include "Scheduler.h"
+#include "HostInfo.h"
+#include "ResultExport.h"
+#include "Benchmark.h"
+#include "BenchmarkCells.h"
+#include "SlabAllocator.h"
+#include "PmrResources.h"
+#include "SlotAllocMethods.h"
+
+BenchmarkOptions benchmarkOptions;
+timer::Timer benchmarkTimer{timer::SteadyClock{}};
+
+// The filters are compiled on their first use; only the main thread enqueues the cells.
+//
+bool PassesFilter(const std::string& filter, const std::string& name)
+{
+	if (filter.empty()) {
+		return true;
+	}
+
+	static std::map<std::string, std::regex> compiledFilters;
+	auto finding = compiledFilters.find(filter);
+	if (finding == std::end(compiledFilters)) {
+		finding = compiledFilters.emplace(filter, std::regex{filter}).first;
+	}
+	return std::regex_search(name, finding->second);
+}
 
 namespace
 {
 	using namespace std::string_literals;
 
-	constexpr auto sep{'|'};
-	constexpr auto nl{'\n'};
-	constexpr bool doWarmup{false};
-
 	struct BenchmarkRecord
 	{
-		int Turns;
+		int Turns; // 0 when calibrated per cell.
 		std::string Distribution;
 		std::string Algorithm;
-		std::map<int, double> SlotsToTimePerTurnNs;
+		std::string Allocator;
+		std::string Primitive;
+		std::string Timer;
+		std::string Generator;
+		std::map<int, BenchmarkCell> SlotsToTimePerTurnNs;
 	};
 
 	std::vector<BenchmarkRecord> benchmarkRecords;
+	std::map<std::pair<std::string, int>, double> baselineTimePerTurnNs; // By distribution and slots.
 
-	class UniformGenerator
+	std::string FormatTurns(int turns)
 	{
-		std::mt19937_64 engine;
-		std::uniform_int_distribution<> distribution;
-	public:
-		explicit UniformGenerator(int slots) : distribution{ 1, slots - 1 } {}
-		int64_t operator()() { return distribution(engine); }
-	};
+		return turns != 0 ? std::to_string(turns) : "auto"s;
+	}
 
-	namespace slotallocmethod
+	// Merges the cells into {benchmarkRecords}, in the order they were enqueued. The baseline of every number of slots
+	// (the void case) is enqueued first, so it is known by the time the other cells of the same number of slots are merged.
+	//
+	void MergeResults(std::vector<CellResult>& results)
 	{
-		struct less_dereference
+		for (auto& result : results)
 		{
-			template<typename PtrType>
-			constexpr bool operator()(const PtrType& a, const PtrType& b) const
-			{
-				return *a < *b;
+			auto& cell = result.Cell;
+			const auto& distribution = result.Distribution;
+			const auto slots = result.Slots;
+
+			if (result.IsBaseline) {
+				baselineTimePerTurnNs[{distribution, slots}] = Summarize(cell.TimePerTurnNs).Median;
+			} else if (benchmarkOptions.SubtractBaseline) {
+				const auto baseline = baselineTimePerTurnNs.find({distribution, slots});
+				if (baseline != std::end(baselineTimePerTurnNs)) {
+					for (auto& sample : cell.TimePerTurnNs) {
+						sample -= baseline->second;
+					}
+				}
 			}
-		};
 
-		struct equal_dereference
-		{
-			using is_transparent = std::true_type;
+			cell.Summary = Summarize(cell.TimePerTurnNs);
 
-			template<typename PtrType>
-			bool operator()(const PtrType& a, const PtrType& b) const
-			{
-				return *a == *b;
-			}
-		};
+			const auto recordTurns = benchmarkOptions.TargetCellMs > 0 ? 0 : benchmarkOptions.Turns;
+			const auto& generator = benchmarkOptions.Generator;
 
-		struct hash_dereference
-		{
-			template<typename PtrType>
-			std::size_t operator()(const PtrType& p) const
-			{
-				return std::hash<std::remove_reference_t<decltype(*p)>>{}(*p);
-			}
-		};
+			auto finding = std::find_if(std::begin(benchmarkRecords), std::end(benchmarkRecords), [&] (const BenchmarkRecord& br) {
+				return br.Turns == recordTurns &&
+					br.Distribution == distribution &&
+					br.Algorithm == result.Algorithm &&
+					br.Allocator == result.Allocator &&
+					br.Timer == benchmarkTimer.Name() &&
+					br.Generator == generator;
+			});
 
+			if (finding == std::end(benchmarkRecords)) {
+				BenchmarkRecord br{recordTurns, distribution, result.Algorithm, result.Allocator, result.Primitive, benchmarkTimer.Name(), generator, {std::make_pair(slots, std::move(cell))}};
+				benchmarkRecords.push_back(std::move(br));
+			} else {
+				finding->SlotsToTimePerTurnNs.insert(std::make_pair(slots, std::move(cell)));
+			}
+		}
+	}
 
-		template<typename T>
-		class NewAllocMethod
-		{
-		public:
-			using PrimitiveType = T;
-			using ElementType = T*;
+	// Picks the cores for the jobs; none if the jobs are to run on the main thread.
+	//
+	std::vector<int> SelectCores(const BenchmarkOptions& options)
+	{
+		if (options.Jobs == 1 && options.Cores.empty() && !options.IsolateDriver && !options.NoisyNeighbours) {
+			return {};
+		}
 
-			using Less = less_dereference;
-			using Equal = equal_dereference;
-			using Hash = hash_dereference;
+		auto cores = options.Cores.empty() ? scheduler::AvailableCores() : options.Cores;
+		if (options.SkipSmtSiblings) {
+			cores = scheduler::WithoutSmtSiblings(cores);
+		}
 
-			T* Alloc() { return new T; }
-			T* Alloc(T&& v) { return new T{std::forward<T>(v)}; }
-			void Free(T* p) { delete p; }
-		};
+		if (options.IsolateDriver && cores.size() > 1) {
+			const auto driverCore = cores.front();
+			scheduler::PinCurrentThread(driverCore);
 
-		template<typename T, typename Allocator>
-		class StdAllocMethod : protected Allocator
-		{
-			using BaseClass = Allocator;
-		public:
-			using PrimitiveType = T;
-			using ElementType = T*;
-
-			using Less = less_dereference;
-			using Equal = equal_dereference;
-			using Hash = hash_dereference;
-
-			T* Alloc() { return typename BaseClass::allocate(1); }
-			T* Alloc(T&& v) { auto p = typename BaseClass::allocate(1); *p = T{std::move(v)}; return p; } // construct is deprecated
-			void Free(T* p) { BaseClass::deallocate(p, 1); }
-		};
+			const auto siblings = scheduler::SmtSiblingsOf(driverCore);
+			cores.erase(std::remove_if(std::begin(cores), std::end(cores), [&] (int core) {
+				return std::find(std::begin(siblings), std::end(siblings), core) != std::end(siblings);
+			}), std::end(cores));
+		}
 
-        /*
-            unique_ptr<~> is too problematic to be contained and manipulated in container-agnostic generic procedure.
-
-                template<typename T>
-                class UniquePtrAllocMethod
-                {
-                public:
-                    using PrimitiveType = T;
-                    using ElementType = std::unique_ptr<T>;
-
-                    using Less = less_dereference;
-                    using Equal = equal_dereference;
-                    using Hash = hash_dereference;
-
-                    ElementType Alloc() { return std::make_unique<T>(); }
-                    ElementType Alloc(T&& v) { return std::make_unique<T>(v); }
-                    void Free(const ElementType&) { }
-                };
-        */
-
-        template<typename T>
-        class SharedPtrAllocMethod
-        {
-        public:
-            using PrimitiveType = T;
-            using ElementType = std::shared_ptr<T>;
-
-            using Less = less_dereference;
-            using Equal = equal_dereference;
-            using Hash = hash_dereference;
-
-            ElementType Alloc() { return std::make_shared<T>(); }
-            ElementType Alloc(T&& v) { return std::make_shared<T>(v); }
-            void Free(const ElementType&) { }
-        };
-
-		template<typename T>
-		class PlfColonyAllocMethod
-		{
-		private:
-			plf::colony<T> _colony;
-		public:
-			using PrimitiveType = T;
-			using ElementType = typename plf::colony<T>::iterator;
-
-			using Less = less_dereference;
-			using Equal = equal_dereference;
-			using Hash = hash_dereference;
-
-			ElementType Alloc() { return Alloc({}); }
-			ElementType Alloc(T&& v) { return _colony.insert(v); }
-			void Free(ElementType p) { _colony.erase(p); }
-		};
+		if (!options.NoisyNeighbours && options.Jobs > 0 && static_cast<size_t>(options.Jobs) < cores.size()) {
+			cores.resize(static_cast<size_t>(options.Jobs));
+		}
+		return cores;
 	}
 
-
-	template<typename AlgorithmTag, typename AllocatorTag>
-	void Benchmark(int turns, int slots, AlgorithmTag algorithmTag, AllocatorTag allocatorTag)
+	void RunBenchmarkJobs(const BenchmarkOptions& options)
 	{
-		namespace chrono = std::chrono;
+		const auto cores = SelectCores(options);
 
-		std::cout << '.';
-		std::flush(std::cout);
-
-		// Warm up the code.
-		//
-		if (doWarmup) {
-			PlayFindAddRemove(turns, slots, UniformGenerator{std::max(slots / 8, 1)}, algorithmTag, allocatorTag);
+		std::cout << "Processing " << benchmarkJobs.size() << " cells";
+		if (!cores.empty()) {
+			std::cout << (options.NoisyNeighbours ? " one at a time, with neighbours running the same cell," : " concurrently") << " on cores";
+			for (const auto core : cores) {
+				std::cout << ' ' << core;
+			}
 		}
+		std::cout << "...";
+		std::flush(std::cout);
 
-		// Run the workload (measuring the time).
-		//
-		auto clock = chrono::system_clock{ };
-		const auto time0 = clock.now();
-		const auto result = PlayFindAddRemove(turns, slots, UniformGenerator{slots}, algorithmTag, allocatorTag);
-		const auto time1 = clock.now();
-
-		const auto distribution = "uniform";
-		const auto algorithm = typeid(typename algorithmTag).name();
-		const volatile auto averageFillRatio = GetRatioOf(result.SumOfSizes, {turns}) / slots;
-		const auto timePerTurnNs = GetRatioOf(chrono::duration_cast<chrono::nanoseconds>(time1 - time0).count(), {turns});
-
-		//std::cout << turns
-		//	<< sep << slots
-		//	<< sep << randomDistributionName
-		//	<< sep << collectionName
-		//	<< sep << averageFillRatio
-		//	<< sep << timePerTurnNs
-		//	<< std::endl;
-
-		auto finding = std::find_if(std::begin(benchmarkRecords), std::end(benchmarkRecords), [&] (const BenchmarkRecord& br) {
-			return br.Turns == turns &&
-				br.Distribution == distribution &&
-				br.Algorithm == algorithm;
+		auto results = scheduler::RunJobs(benchmarkJobs, cores, options.NoisyNeighbours, [] {
+			std::cout << '.';
+			std::flush(std::cout);
 		});
 
-		if (finding == std::end(benchmarkRecords)) {
-			BenchmarkRecord br{turns, std::move(distribution), std::move(algorithm), {std::make_pair(slots, timePerTurnNs)}};
-			benchmarkRecords.push_back(std::move(br));
-		} else {
-			finding->SlotsToTimePerTurnNs.insert(std::make_pair(slots, timePerTurnNs));
+		for (auto& jobResults : results) {
+			MergeResults(jobResults);
 		}
+		benchmarkJobs.clear();
 	}
 }
 
-void Benchmark(int turns)
+void Benchmark(const BenchmarkOptions& options)
 {
-	std::cout << "The benchmark performs {turns}=" << std::to_string(turns) << " number of iterations. " << nl
-		<< "Every turn the pseudo-random generator generates a number within the range from 0 to {space}-1 using {distribution}. " << nl
+	const auto turns = options.Turns;
+	benchmarkOptions = options;
+	benchmarkTimer = timer::MakeTimer(options.Timer);
+
+	// For each number of slots, every selected family enqueues its cells.
+	//
+	const auto enqueueCells = [&] {
+		for (const auto slots : options.Slots) {
+			for (const auto& family : BenchmarkFamilies()) {
+				if (PassesFilter(options.FamilyFilter, family.Name) || (family.Rank == 0 && options.SubtractBaseline)) {
+					family.Enqueue(turns, slots);
+				}
+			}
+		}
+	};
+
+	if (options.ListCells) {
+		std::cout << "slots" << sep << "algorithm" << sep << "allocator" << std::endl;
+		enqueueCells();
+		return;
+	}
+
+	if (options.TargetCellMs > 0) {
+		std::cout << "The benchmark performs {turns} number of iterations, calibrated for every cell to last about " << options.TargetCellMs << " ms. " << nl;
+	} else {
+		std::cout << "The benchmark performs {turns}=" << std::to_string(turns) << " number of iterations. " << nl;
+	}
+	std::cout << "Every turn the pseudo-random generator generates a number within the range from 0 to {space}-1 using {distribution}. " << nl
 		<< "That number is placed into {dataset} collection, or it is removed from it if the number was already present. "
 		<< std::endl;
 
-	std::cout << "Processing...";
+	std::cout << "Timing with " << benchmarkTimer.Name() << " (" << benchmarkTimer.NsPerTick() << " ns per tick), "
+		<< "repeating every measurement " << options.Repetitions << " time(s)";
+	if (options.TargetRelativeCi > 0) {
+		std::cout << " or until the 95% CI is narrower than " << options.TargetRelativeCi * 100 << "% of the mean (at most " << options.MaxRepetitions << " times)";
+	}
+	std::cout << '.' << std::endl;
+
+	std::cout << "Slots are generated by " << options.Generator;
+	if (options.PregenerateSlots || options.Generator != DefaultUniformGenerator::Name()) {
+		std::cout << ", before every run" << (options.HugePages ? " into a buffer backed by huge pages" : "");
+	}
+	std::cout << '.' << std::endl;
+	std::cout << "The vectorized linear searches use " << simdsearch::InstructionSetName(simdsearch::SupportedInstructionSet()) << '.' << std::endl;
+	if (options.ArenaHugePages) {
+		std::cout << "The arenas of slots are backed by huge pages." << std::endl;
+	}
+	if (options.SubtractBaseline) {
+		std::cout << "The time of the generator alone (void) is subtracted from all the other results." << std::endl;
+	}
+	if (options.ProfileMemory) {
+		std::cout << "The memory of every cell is profiled in an additional run." << std::endl;
+	}
+	if (options.PerfCounters) {
+		const auto& counters = perfcounters::ThreadCounterGroup();
+		if (counters.Available()) {
+			std::cout << "Counting per turn:";
+			for (int event{0}; event < perfcounters::events; ++event) {
+				std::cout << ' ' << perfcounters::eventNames[event] << (counters.IsCounting(event) ? "" : " (not available)");
+			}
+			std::cout << '.' << std::endl;
+		} else {
+			std::cout << "The performance counters are not available on this host (perf_event_open failed); their columns are left empty." << std::endl;
+		}
+	}
+
+	std::cout << "Distributions:";
+	for (const auto& distribution : options.Distributions) {
+		std::cout << ' ' << distribution;
+	}
+	std::cout << " (zipf theta=" << options.Shape.ZipfTheta
+		<< ", hot set: " << options.Shape.HotProbability * 100 << "% of turns hit " << options.Shape.HotFraction * 100 << "% of slots)."
+		<< std::endl;
+	for (const auto& distribution : options.Distributions) {
+		if (const auto mappedTrace = FindTrace(distribution)) {
+			std::cout << "The trace " << distribution << " holds " << mappedTrace->Count() << " turns over " << mappedTrace->Slots()
+				<< " slots; it is played only for the spaces at least that large." << std::endl;
+		}
+	}
 
 	//std::cout << "turns"
 	//	<< sep << "slots"
@@ -218,198 +254,614 @@ void Benchmark(int turns)
 	//	<< sep << "time_per_turn_ns"
 	//	<< std::endl;
 
-	auto slotsSeries = IntegerConstants<
-		2,
-		8,
-		64,
-		256,
-		1 * 1024,
-		4 * 1024,
-		16 * 1024,
-		64 * 1024,
-		256 * 1024,
-		1 * 1024 * 1024,
-		4 * 1024 * 1024
-		//16 * 1024 * 1024,
-		//64 * 1024 * 1024,
-		//256 * 1024 * 1024
-	>{};
-
-	auto maxSlotsForBitset = IntegerConstants<4 * 1024 * 1024>{};
-	auto maxSlotsForSequence = IntegerConstants<4 * 1024>{};
-
-	// For each number of slots...
-	//
-	ForEachIntegerConstant(slotsSeries, [=] (auto slots)
-	{
-		std::cout << slots.value();
-
-		// void is special - it only invokes the pseudo-random generator.
-		//
-		Benchmark(turns, slots.value(), Tag<void>{}, Tag<void>{});
-
-		// In positional algorithm, slot is determined by the position (index) in a pre-allocated space.
-		//
-		{
-			ForEachTag(Tag<
-				PositionalTag<std::unique_ptr<bool[]>, uint8_t>,
-				PositionalTag<std::unique_ptr<bool[]>, int8_t>,
-				PositionalTag<std::unique_ptr<bool[]>, uint16_t>,
-				PositionalTag<std::unique_ptr<bool[]>, int16_t>,
-				PositionalTag<std::unique_ptr<bool[]>, uint32_t>,
-				PositionalTag<std::unique_ptr<bool[]>, int32_t>,
-				PositionalTag<std::unique_ptr<bool[]>, uint64_t>,
-				PositionalTag<std::unique_ptr<bool[]>, int64_t>,
-				PositionalTag<std::unique_ptr<uint8_t[]>>,
-				PositionalTag<std::unique_ptr<int8_t[]>>,
-				PositionalTag<std::unique_ptr<uint16_t[]>>,
-				PositionalTag<std::unique_ptr<int16_t[]>>,
-				PositionalTag<std::unique_ptr<uint32_t[]>>,
-				PositionalTag<std::unique_ptr<int32_t[]>>,
-				PositionalTag<std::unique_ptr<uint64_t[]>>,
-				PositionalTag<std::unique_ptr<int64_t[]>>,
-				PositionalTag<std::vector<bool>>
-			>{},
-				[=] (auto algorithmTagTag)
-			{
-				using AlgorithmTag = decltype(algorithmTagTag)::value_type;
-				Benchmark(turns, slots.value(), AlgorithmTag{}, Tag<void>{});
-			});
-
-			if (slots.value() <= maxSlotsForBitset.value())
-			{
-				Benchmark(turns, slots.value(), PositionalTag<std::bitset<slots.value()>>{}, Tag<void>{});
+	std::cout << "Algorithm families:";
+	for (const auto& family : BenchmarkFamilies()) {
+		std::cout << ' ' << family.Name;
+	}
+	std::cout << '.' << std::endl;
+	if (!options.FamilyFilter.empty() || !options.AlgorithmFilter.empty() || !options.AllocatorFilter.empty() || !options.Primitives.empty()) {
+		std::cout << "Playing only the cells of the families matching /" << options.FamilyFilter << "/, the algorithms matching /" << options.AlgorithmFilter
+			<< "/ and the allocators matching /" << options.AllocatorFilter << "/";
+		if (!options.Primitives.empty()) {
+			std::cout << ", of the primitive types";
+			for (const auto& primitive : options.Primitives) {
+				std::cout << ' ' << primitive;
 			}
 		}
+		std::cout << '.' << std::endl;
+	}
 
-		// In container-based algorithm, slot is an unique element in the colleciton.
-		//
-		{
-			ForEachTag(Tag<
-				int8_t,
-				uint8_t,
-				int16_t,
-				uint16_t,
-				int32_t,
-				uint32_t,
-				int64_t,
-				uint64_t
-				//intbig_t<128>
-			>{},
-				[=] (auto primitiveTag)
-			{
-				using PrimitiveType = decltype(primitiveTag)::value_type;
-
-				ForEachTag(Tag<
-					PrimitiveAllocMethod<PrimitiveType>,
-					slotallocmethod::NewAllocMethod<PrimitiveType>,
-					slotallocmethod::StdAllocMethod<PrimitiveType, std::allocator<PrimitiveType>>,
-                    slotallocmethod::SharedPtrAllocMethod<PrimitiveType>,
-                    slotallocmethod::PlfColonyAllocMethod<PrimitiveType>
-				>{},
-					[=] (auto slotAllocTag)
-				{
-					using SlotAllocType = decltype(slotAllocTag)::value_type;
-					using ElementType = typename SlotAllocType::ElementType;
-
-					ForEachTag(Tag<
-						std::allocator<ElementType>
-					>{},
-						[=] (auto collectionAllocatorTag)
-					{
-						using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
-
-						// Available integer bits must be capable of addressing all the slots.
-						//
-						if (static_cast<uint64_t>(slots.value()) > static_cast<uint64_t>(std::numeric_limits<PrimitiveType>::max())) {
-							return;
-						}
-
-						// Sequence-based algorithms
-						// When there are many slots, these work too slowly to be included in benchmark.
-						//
-						if (slots.value() <= maxSlotsForSequence.value())
-						{
-							ForEachTag(Tag<
-								SequenceUnsortedTag<std::vector<ElementType, CollectionAllocatorType>>,
-								SequenceSortedTag<std::vector<ElementType, CollectionAllocatorType>>,
-								SequenceUnsortedTag<std::deque<ElementType, CollectionAllocatorType>>,
-								SequenceSortedTag<std::deque<ElementType, CollectionAllocatorType>>,
-								SequenceUnsortedTag<std::list<ElementType, CollectionAllocatorType>>,
-								SequenceSortedTag<std::list<ElementType, CollectionAllocatorType>>
-							>{},
-								[=] (auto algorithmTagTag)
-							{
-								using AlgorithmTag = decltype(algorithmTagTag)::value_type;
-								Benchmark(turns, slots.value(), AlgorithmTag{}, slotAllocTag);
-							});
-
-							//Benchmark(turns, slots.value(), Tag<SequenceOtherTag<plf::colony<PrimitiveType>>>{}, Tag<void>{});
-						}
+	enqueueCells();
 
-						// Set-based algorithms
-						//
-						ForEachTag(Tag<
-							SetTag<std::set<ElementType, SlotAllocType::Less, CollectionAllocatorType>>,
-							SetTag<std::unordered_set<ElementType, SlotAllocType::Hash, SlotAllocType::Equal, CollectionAllocatorType>>,
-							SetTag<boost::container::flat_set<ElementType, SlotAllocType::Less, CollectionAllocatorType>>,
-							SetTag<stx::btree_set<ElementType, SlotAllocType::Less, stx::btree_default_set_traits<ElementType>, CollectionAllocatorType>>,
-							SetTag<btree::btree_set<ElementType, SlotAllocType::Less, CollectionAllocatorType, 256>>,
-							SetTag<google::sparse_hash_set<ElementType, SlotAllocType::Hash, SlotAllocType::Equal, CollectionAllocatorType>>,
-							SetTag<google::dense_hash_set<ElementType, SlotAllocType::Hash, SlotAllocType::Equal, CollectionAllocatorType>>,
-							SetTag<tsl::hopscotch_set<ElementType, SlotAllocType::Hash, SlotAllocType::Equal, CollectionAllocatorType, 62U, std::ratio<2i64, 1i64>>>
-						>{},
-							[=] (auto algorithmTagTag)
-						{
-							using AlgorithmTag = decltype(algorithmTagTag)::value_type;
-							Benchmark(turns, slots.value(), AlgorithmTag{}, slotAllocTag);
-						});
-					});
-				});
-			});
-		}
-	});
+	RunBenchmarkJobs(options);
 
 	std::cout << std::endl;
 
 	{
 		std::cout << "turns"
 			<< sep << "distribution"
-			<< sep << "algorithm";
+			<< sep << "algorithm"
+			<< sep << "allocator"
+			<< sep << "timer"
+			<< sep << "generator";
 
-		ForEachIntegerConstant(slotsSeries, [=] (auto slots) {
-			std::cout << sep << "time:s" << (slots.value() - 1);
-		});
+		for (const auto slots : options.Slots) {
+			std::cout << sep << "time:s" << (slots - 1);
+		}
 
 		std::cout << std::endl;
 
 		for (const auto& br : benchmarkRecords)
 		{
-			std::cout << br.Turns
+			std::cout << FormatTurns(br.Turns)
 				<< sep << br.Distribution
-				<< sep << br.Algorithm;
+				<< sep << br.Algorithm
+				<< sep << br.Allocator
+				<< sep << br.Timer
+				<< sep << br.Generator;
 
-			ForEachIntegerConstant(slotsSeries, [=] (auto slots)
+			for (const auto slots : options.Slots)
 			{
 				std::cout << sep;
 
-				auto finding = br.SlotsToTimePerTurnNs.find(slots.value());
+				auto finding = br.SlotsToTimePerTurnNs.find(slots);
 				if (finding != std::end(br.SlotsToTimePerTurnNs)) {
-					std::cout << finding->second;
+					std::cout << finding->second.Summary.Median;
 				}
-			});
+			}
 
 			std::cout << std::endl;
 		}
 	}
 
-} // namespace
+	std::cout << std::endl;
 
+	// Per-cell statistics of time per turn (in nanoseconds), followed by all the samples.
+	//
+	{
+		std::cout << "turns"
+			<< sep << "distribution"
+			<< sep << "algorithm"
+			<< sep << "allocator"
+			<< sep << "timer"
+			<< sep << "generator"
+			<< sep << "slots"
+			<< sep << "cell_turns"
+			<< sep << "repetitions"
+			<< sep << "min"
+			<< sep << "median"
+			<< sep << "mean"
+			<< sep << "stddev"
+			<< sep << "p90"
+			<< sep << "p99"
+			<< sep << "mad";
+		if (options.PerfCounters) {
+			for (const auto eventName : perfcounters::eventNames) {
+				std::cout << sep << eventName;
+			}
+		}
+		if (options.ProfileMemory) {
+			std::cout << sep << "allocations"
+				<< sep << "bytes_allocated"
+				<< sep << "peak_live_bytes"
+				<< sep << "bytes_per_element"
+				<< sep << "peak_rss_growth_bytes";
+		}
+		std::cout << sep << "probe_lengths"
+			<< sep << "samples"
+			<< std::endl;
+
+		for (const auto& br : benchmarkRecords)
+		{
+			for (const auto& slotsAndCell : br.SlotsToTimePerTurnNs)
+			{
+				const auto& summary = slotsAndCell.second.Summary;
+
+				std::cout << FormatTurns(br.Turns)
+					<< sep << br.Distribution
+					<< sep << br.Algorithm
+					<< sep << br.Allocator
+					<< sep << br.Timer
+					<< sep << br.Generator
+					<< sep << slotsAndCell.first
+					<< sep << slotsAndCell.second.Turns
+					<< sep << summary.Count
+					<< sep << summary.Min
+					<< sep << summary.Median
+					<< sep << summary.Mean
+					<< sep << summary.StdDev
+					<< sep << summary.P90
+					<< sep << summary.P99
+					<< sep << summary.Mad;
+				if (options.PerfCounters) {
+					for (const auto count : slotsAndCell.second.CountsPerTurn) {
+						std::cout << sep;
+						if (!std::isnan(count)) {
+							std::cout << count;
+						}
+					}
+				}
+				if (options.ProfileMemory) {
+					const auto& memory = slotsAndCell.second.Memory;
+					std::cout << sep << memory.Allocations
+						<< sep << memory.BytesAllocated
+						<< sep << memory.PeakLiveBytes
+						<< sep << memory.BytesPerElement
+						<< sep << memory.PeakResidentGrowthBytes;
+				}
+				std::cout << sep;
+				for (const auto count : slotsAndCell.second.ProbeLengths) {
+					std::cout << count << ' ';
+				}
+				std::cout << sep;
+
+				for (const auto sample : slotsAndCell.second.TimePerTurnNs) {
+					std::cout << sample << ' ';
+				}
+
+				std::cout << std::endl;
+			}
+		}
+	}
+
+	// The same per-cell statistics, exported along with the primitive types.
+	//
+	auto table = resultexport::ResultTable{{
+		{"turns", resultexport::ColumnType::Integer}, // 0 when calibrated per cell.
+		{"distribution", resultexport::ColumnType::String},
+		{"algorithm", resultexport::ColumnType::String},
+		{"allocator", resultexport::ColumnType::String},
+		{"primitive", resultexport::ColumnType::String},
+		{"timer", resultexport::ColumnType::String},
+		{"generator", resultexport::ColumnType::String},
+		{"slots", resultexport::ColumnType::Integer},
+		{"cell_turns", resultexport::ColumnType::Integer},
+		{"repetitions", resultexport::ColumnType::Integer},
+		{"min_ns", resultexport::ColumnType::Real},
+		{"median_ns", resultexport::ColumnType::Real},
+		{"mean_ns", resultexport::ColumnType::Real},
+		{"stddev_ns", resultexport::ColumnType::Real},
+		{"p90_ns", resultexport::ColumnType::Real},
+		{"p99_ns", resultexport::ColumnType::Real},
+		{"mad_ns", resultexport::ColumnType::Real},
+		{"samples_ns", resultexport::ColumnType::RealList}
+	}};
+	if (options.PerfCounters) {
+		for (const auto eventName : perfcounters::eventNames) {
+			table.Columns.push_back({eventName + "_per_turn"s, resultexport::ColumnType::Real});
+		}
+	}
+	if (options.ProfileMemory) {
+		table.Columns.push_back({"allocations", resultexport::ColumnType::Integer});
+		table.Columns.push_back({"bytes_allocated", resultexport::ColumnType::Integer});
+		table.Columns.push_back({"peak_live_bytes", resultexport::ColumnType::Integer});
+		table.Columns.push_back({"bytes_per_element", resultexport::ColumnType::Real});
+		table.Columns.push_back({"peak_rss_growth_bytes", resultexport::ColumnType::Integer}); // -1 if unknown.
+	}
+	table.Columns.push_back({"probe_lengths", resultexport::ColumnType::RealList}); // Slots per probe length; empty unless counted.
+	for (const auto& br : benchmarkRecords) {
+		for (const auto& slotsAndCell : br.SlotsToTimePerTurnNs) {
+			const auto& summary = slotsAndCell.second.Summary;
+			auto row = std::vector<resultexport::Value>{br.Turns, br.Distribution, br.Algorithm, br.Allocator, br.Primitive, br.Timer, br.Generator,
+				slotsAndCell.first, slotsAndCell.second.Turns, summary.Count,
+				summary.Min, summary.Median, summary.Mean, summary.StdDev, summary.P90, summary.P99, summary.Mad,
+				slotsAndCell.second.TimePerTurnNs};
+			if (options.PerfCounters) {
+				row.insert(std::end(row), std::begin(slotsAndCell.second.CountsPerTurn), std::end(slotsAndCell.second.CountsPerTurn));
+			}
+			if (options.ProfileMemory) {
+				const auto& memory = slotsAndCell.second.Memory;
+				row.insert(std::end(row), {memory.Allocations, memory.BytesAllocated, memory.PeakLiveBytes, memory.BytesPerElement, memory.PeakResidentGrowthBytes});
+			}
+			row.push_back(slotsAndCell.second.ProbeLengths);
+			table.AddRow(std::move(row));
+		}
+	}
+	ExportResults(options, "find-add-remove", table);
+}
+
+void ExportResults(const BenchmarkOptions& options, const std::string& game, const resultexport::ResultTable& table)
+{
+	if (options.ExportCsv.empty() && options.ExportJsonLines.empty() && options.ExportColumnar.empty()) {
+		return;
+	}
+
+	auto metadata = resultexport::Metadata{
+		{"game", game},
+		{"command_line", options.CommandLine},
+		{"timer", benchmarkTimer.Name()},
+		{"timer.ns_per_tick", resultexport::FormatReal(benchmarkTimer.NsPerTick())},
+		{"simd_search", simdsearch::InstructionSetName(simdsearch::SupportedInstructionSet())}
+	};
+	for (const auto& entry : hostinfo::Collect()) {
+		metadata.push_back(entry);
+	}
+
+	const auto exportTo = [&] (const std::string& path, void (*write)(const std::string&, const resultexport::Metadata&, const resultexport::ResultTable&)) {
+		if (!path.empty()) {
+			write(path, metadata, table);
+			std::cout << "Exported " << table.Rows.size() << " rows to " << path << '.' << std::endl;
+		}
+	};
+	exportTo(options.ExportCsv, resultexport::WriteCsv);
+	exportTo(options.ExportJsonLines, resultexport::WriteJsonLines);
+	exportTo(options.ExportColumnar, resultexport::WriteColumnar);
+}
+
+// Records slots of the first selected distribution to a trace, instead of running the benchmark.
+// The values are streamed to the file one by one, so the trace can be larger than the memory.
+//
+void RecordTrace(const BenchmarkOptions& options)
+{
+	benchmarkOptions = options;
+
+	const auto& distribution = options.Distributions.front();
+	const auto slots = options.TraceSlots;
+	const auto turns = options.TraceTurns != 0 ? options.TraceTurns : options.Turns;
+
+	if (const auto mappedTrace = FindTrace(distribution)) {
+		if (mappedTrace->Count() < turns || mappedTrace->Slots() > slots) {
+			throw std::invalid_argument{"The source trace is too short or does not fit into the space: " + distribution};
+		}
+		trace::Record(options.RecordTrace, slots, turns, TraceReplayGenerator{*mappedTrace});
+	} else if (distribution != "uniform") {
+		trace::Record(options.RecordTrace, slots, turns, NonUniformDistributions().at(distribution)(slots, options.Shape));
+	} else {
+		WithUniformGenerator(options.Generator, slots, [&] (auto randomGenerator) {
+			trace::Record(options.RecordTrace, slots, turns, randomGenerator);
+		});
+	}
+
+	std::cout << "Recorded " << turns << " turns of " << distribution
+		<< (distribution == "uniform" ? " (" + options.Generator + ")" : ""s)
+		<< " over " << slots << " slots to " << options.RecordTrace << '.' << std::endl;
+}
+
+
+namespace
+{
+	std::vector<std::string> Split(const std::string& text, char separator)
+	{
+		std::vector<std::string> parts;
+		std::istringstream stream{text};
+		for (std::string part; std::getline(stream, part, separator);) {
+			parts.push_back(part);
+		}
+		return parts;
+	}
+
+	std::vector<int> ParseIntegers(const std::string& text)
+	{
+		std::vector<int> integers;
+		for (const auto& part : Split(text, ',')) {
+			integers.push_back(std::stoi(part));
+		}
+		return integers;
+	}
+
+	// Parses a list of numbers of slots, each either a number or a geometric range FIRST..LAST[*FACTOR] (FACTOR defaults to 2).
+	// The numbers may have a binary suffix: K, M or G.
+	//
+	std::vector<int> ParseSlots(const std::string& text)
+	{
+		const auto parseNumber = [] (const std::string& number) {
+			const auto outOfRange = std::invalid_argument{"The number of slots must be within 2 and " + std::to_string(std::numeric_limits<int>::max()) + ": " + number};
+			size_t length{0};
+			int64_t value{0};
+			try {
+				value = std::stoll(number, &length);
+			} catch (const std::out_of_range&) {
+				throw outOfRange;
+			} catch (const std::invalid_argument&) {
+				throw std::invalid_argument{"Invalid number of slots: " + number};
+			}
+
+			const auto suffix = number.substr(length);
+			int shift{0};
+			if (suffix == "K" || suffix == "k") {
+				shift = 10;
+			} else if (suffix == "M" || suffix == "m") {
+				shift = 20;
+			} else if (suffix == "G" || suffix == "g") {
+				shift = 30;
+			} else if (!suffix.empty()) {
+				throw std::invalid_argument{"Invalid number of slots: " + number};
+			}
+
+			// The range is checked before the shift, which would overflow (or be undefined for a negative value).
+			//
+			if (value <= 0 || value > (std::numeric_limits<int>::max() >> shift)) {
+				throw outOfRange;
+			}
+			value <<= shift;
+			if (value < 2) {
+				throw outOfRange;
+			}
+			return value;
+		};
+
+		std::vector<int> slots;
+		for (const auto& part : Split(text, ','))
+		{
+			const auto range = part.find("..");
+			if (range == std::string::npos) {
+				slots.push_back(static_cast<int>(parseNumber(part)));
+				continue;
+			}
+
+			const auto step = part.find('*', range);
+			const auto first = parseNumber(part.substr(0, range));
+			const auto last = parseNumber(part.substr(range + 2, step != std::string::npos ? step - range - 2 : std::string::npos));
+			if (first > last) {
+				throw std::invalid_argument{"The first number of a range of slots must not exceed the last: " + part};
+			}
+			const auto factor = step != std::string::npos ? std::stoll(part.substr(step + 1)) : 2;
+			if (factor < 2) {
+				throw std::invalid_argument{"The factor of a range of slots must be at least 2: " + part};
+			}
+			for (auto value = first; value <= last; value *= factor) {
+				slots.push_back(static_cast<int>(value));
+				if (value > last / factor) {
+					break;
+				}
+			}
+		}
+
+		std::sort(std::begin(slots), std::end(slots));
+		slots.erase(std::unique(std::begin(slots), std::end(slots)), std::end(slots));
+		return slots;
+	}
+
+	std::vector<std::string> DistributionNames()
+	{
+		std::vector<std::string> names{"uniform"};
+		for (const auto& distribution : NonUniformDistributions()) {
+			names.push_back(distribution.first);
+		}
+		return names;
+	}
+
+	// Usage: far-cpp-benchmark [turns] [--timer=steady_clock|monotonic_raw|tsc]
+	//                          [--slots=N|FIRST..LAST[*FACTOR],...] [--family=REGEX] [--algorithm=REGEX] [--allocator=REGEX]
+	//                          [--primitive=TYPE,...] [--list]
+	//                          [--repetitions=N] [--target-ci=FRACTION] [--max-repetitions=N]
+	//                          [--target-cell-ms=MS] [--max-turns=N]
+	//                          [--pregenerate] [--huge-pages] [--arena-huge-pages] [--subtract-baseline] [--generator=NAME] [--perf-counters] [--profile-memory]
+	//                          [--distribution=NAME|trace:PATH,...|all] [--zipf-theta=THETA] [--hot-fraction=F] [--hot-probability=P]
+	//                          [--record-trace=PATH [--trace-turns=N] [--trace-slots=N]]
+	//                          [--jobs=N] [--cores=LIST] [--skip-smt-siblings] [--isolate-driver] [--noisy-neighbours]
+	//                          [--concurrent [--threads=N,...] [--concurrent-slots=N,...] [--read-percent=P]]
+	//                          [--export-csv=PATH] [--export-jsonl=PATH] [--export-columnar=PATH]
+	//
+	BenchmarkOptions ParseOptions(const int argc, const char* const argv[])
+	{
+		auto options = BenchmarkOptions{};
+
+		for (int i{0}; i < argc; ++i) {
+			options.CommandLine += (i != 0 ? " " : "") + std::string{argv[i]};
+		}
+
+		for (int i{1}; i < argc; ++i)
+		{
+			const auto arg = std::string{argv[i]};
+			const auto separator = arg.find('=');
+			const auto name = arg.substr(0, separator);
+			const auto value = separator != std::string::npos ? arg.substr(separator + 1) : std::string{};
+
+			if (name == "--timer") {
+				options.Timer = value;
+			} else if (name == "--slots") {
+				options.Slots = ParseSlots(value);
+			} else if (name == "--family") {
+				options.FamilyFilter = value;
+			} else if (name == "--algorithm") {
+				options.AlgorithmFilter = value;
+			} else if (name == "--allocator") {
+				options.AllocatorFilter = value;
+			} else if (name == "--primitive") {
+				options.Primitives = Split(value, ',');
+			} else if (name == "--list") {
+				options.ListCells = true;
+			} else if (name == "--repetitions") {
+				options.Repetitions = std::stoi(value);
+			} else if (name == "--target-ci") {
+				options.TargetRelativeCi = std::stod(value);
+			} else if (name == "--max-repetitions") {
+				options.MaxRepetitions = std::stoi(value);
+			} else if (name == "--target-cell-ms") {
+				options.TargetCellMs = std::stod(value);
+			} else if (name == "--max-turns") {
+				options.MaxTurns = std::stoi(value);
+			} else if (name == "--pregenerate") {
+				options.PregenerateSlots = true;
+			} else if (name == "--huge-pages") {
+				options.PregenerateSlots = true;
+				options.HugePages = true;
+			} else if (name == "--arena-huge-pages") {
+				options.ArenaHugePages = true;
+			} else if (name == "--subtract-baseline") {
+				options.SubtractBaseline = true;
+			} else if (name == "--perf-counters") {
+				options.PerfCounters = true;
+			} else if (name == "--profile-memory") {
+				options.ProfileMemory = true;
+			} else if (name == "--generator") {
+				options.Generator = value;
+			} else if (name == "--distribution") {
+				options.Distributions = value == "all" ? DistributionNames() : Split(value, ',');
+			} else if (name == "--zipf-theta") {
+				options.Shape.ZipfTheta = std::stod(value);
+			} else if (name == "--hot-fraction") {
+				options.Shape.HotFraction = std::stod(value);
+			} else if (name == "--hot-probability") {
+				options.Shape.HotProbability = std::stod(value);
+			} else if (name == "--record-trace") {
+				options.RecordTrace = value;
+			} else if (name == "--trace-turns") {
+				options.TraceTurns = std::stoll(value);
+			} else if (name == "--trace-slots") {
+				options.TraceSlots = std::stoi(value);
+			} else if (name == "--jobs") {
+				options.Jobs = std::stoi(value);
+			} else if (name == "--cores") {
+				options.Cores = scheduler::ParseCoreList(value);
+			} else if (name == "--skip-smt-siblings") {
+				options.SkipSmtSiblings = true;
+			} else if (name == "--isolate-driver") {
+				options.IsolateDriver = true;
+			} else if (name == "--noisy-neighbours") {
+				options.NoisyNeighbours = true;
+			} else if (name == "--concurrent") {
+				options.Concurrent = true;
+			} else if (name == "--threads") {
+				options.Threads = ParseIntegers(value);
+			} else if (name == "--concurrent-slots") {
+				options.ConcurrentSlots = ParseIntegers(value);
+			} else if (name == "--read-percent") {
+				options.ReadPercent = std::stoi(value);
+			} else if (name == "--export-csv" && !value.empty()) {
+				options.ExportCsv = value;
+			} else if (name == "--export-jsonl" && !value.empty()) {
+				options.ExportJsonLines = value;
+			} else if (name == "--export-columnar" && !value.empty()) {
+				options.ExportColumnar = value;
+			} else if (i == 1 && name.compare(0, 2, "--") != 0) {
+				options.Turns = std::stoi(arg);
+			} else {
+				throw std::invalid_argument{"Unknown argument: " + arg};
+			}
+		}
+
+		if (options.Repetitions < 1) {
+			throw std::invalid_argument{"At least one repetition is required"};
+		}
+		if (options.Turns < 1 || options.MaxTurns < options.Turns) {
+			throw std::invalid_argument{"The number of turns must be within 1 and --max-turns"};
+		}
+		const auto generators = UniformGeneratorNames();
+		if (std::find(std::begin(generators), std::end(generators), options.Generator) == std::end(generators)) {
+			throw std::invalid_argument{"Unknown generator: " + options.Generator};
+		}
+		const auto distributions = DistributionNames();
+		for (const auto& distribution : options.Distributions) {
+			if (const auto mappedTrace = FindTrace(distribution)) {
+				if (mappedTrace->Count() == 0) {
+					throw std::invalid_argument{"Empty trace: " + distribution};
+				}
+			} else if (std::find(std::begin(distributions), std::end(distributions), distribution) == std::end(distributions)) {
+				throw std::invalid_argument{"Unknown distribution: " + distribution};
+			}
+		}
+		if (options.Distributions.empty()) {
+			throw std::invalid_argument{"At least one distribution is required"};
+		}
+		// Written so that NaN fails the checks too.
+		//
+		if (!(options.Shape.ZipfTheta > 0)) {
+			throw std::invalid_argument{"The Zipf theta must be positive"};
+		}
+		if (!(options.Shape.HotFraction > 0 && options.Shape.HotFraction <= 1)) {
+			throw std::invalid_argument{"The hot fraction must be within 0 (exclusive) and 1"};
+		}
+		if (!(options.Shape.HotProbability >= 0 && options.Shape.HotProbability <= 1)) {
+			throw std::invalid_argument{"The hot probability must be within 0 and 1"};
+		}
+		if (options.ReadPercent < 0 || options.ReadPercent > 100) {
+			throw std::invalid_argument{"The read percentage must be within 0 and 100"};
+		}
+		if (std::any_of(std::begin(options.Threads), std::end(options.Threads), [] (int threads) { return threads < 1; }) ||
+			std::any_of(std::begin(options.ConcurrentSlots), std::end(options.ConcurrentSlots), [] (int slots) { return slots < 2; })) {
+			throw std::invalid_argument{"Every thread count must be positive and every number of slots at least 2"};
+		}
+		if (options.Jobs < 0) {
+			throw std::invalid_argument{"The number of jobs must not be negative"};
+		}
+		if (options.TraceSlots < 2 || options.TraceTurns < 0) {
+			throw std::invalid_argument{"A trace needs at least 2 slots and a non-negative number of turns"};
+		}
+		for (const auto& filter : {options.FamilyFilter, options.AlgorithmFilter, options.AllocatorFilter}) {
+			try {
+				std::regex{filter};
+			} catch (const std::regex_error&) {
+				throw std::invalid_argument{"Invalid regular expression: " + filter};
+			}
+		}
+		const auto primitives = PrimitiveNames();
+		for (const auto& primitive : options.Primitives) {
+			if (std::find(std::begin(primitives), std::end(primitives), primitive) == std::end(primitives)) {
+				throw std::invalid_argument{"Unknown primitive type: " + primitive};
+			}
+		}
+		if (options.Slots.empty()) {
+			ForEachIntegerConstant(SlotsSeries{}, [&] (auto slots) {
+				options.Slots.push_back(slots.value());
+			});
+		}
+		// Fail before the sweep rather than after it.
+		//
+		for (const auto& path : {options.ExportCsv, options.ExportJsonLines, options.ExportColumnar}) {
+			if (!path.empty() && !std::ofstream{path, std::ios::app}) {
+				throw std::invalid_argument{"Cannot create export: " + path};
+			}
+		}
+		if (options.MaxRepetitions == 0) {
+			options.MaxRepetitions = std::max(options.Repetitions, 100);
+		}
+
+		return options;
+	}
+}
 
 int main(const int argc, const char* const argv[])
 {
-	const auto turns = argc >= 2 ? std::stoi(argv[1]) : 1024;
+	auto options = BenchmarkOptions{};
+	try {
+		options = ParseOptions(argc, argv);
+		timer::MakeTimer(options.Timer);
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << nl << "Available timers:";
+		for (const auto& name : timer::AvailableTimers()) {
+			std::cerr << ' ' << name;
+		}
+		std::cerr << nl << "Available generators:";
+		for (const auto& name : UniformGeneratorNames()) {
+			std::cerr << ' ' << name;
+		}
+		std::cerr << nl << "Available distributions:";
+		for (const auto& name : DistributionNames()) {
+			std::cerr << ' ' << name;
+		}
+		std::cerr << " trace:PATH" << nl << "Available families:";
+		for (const auto& family : BenchmarkFamilies()) {
+			std::cerr << ' ' << family.Name;
+		}
+		std::cerr << nl << "Available primitive types:";
+		for (const auto& name : PrimitiveNames()) {
+			std::cerr << ' ' << name;
+		}
+		std::cerr << std::endl;
+		return 1;
+	}
+
+	if (!options.RecordTrace.empty()) {
+		try {
+			RecordTrace(options);
+		} catch (const std::exception& e) {
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+		return 0;
+	}
 
-	Benchmark(turns);
+	try {
+		if (options.Concurrent) {
+			ConcurrentBenchmark(options);
+		} else {
+			Benchmark(options);
+		}
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 	return 0;
 }
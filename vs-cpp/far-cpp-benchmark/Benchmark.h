@@ -0,0 +1,142 @@
+#pragma once
+
+// Options and state of the benchmark driver, shared by the translation units of the games and of the algorithm families.
+
+constexpr auto sep{'|'};
+constexpr auto nl{'\n'};
+
+struct BenchmarkOptions
+{
+	int Turns{1024};
+	std::string Timer{timer::SteadyClock::Name()};
+
+	// The numbers of slots to play (SlotsSeries if empty).
+	//
+	std::vector<int> Slots;
+
+	// Only the cells passing all the filters are played. The filters are regular expressions (ECMAScript, matching anywhere
+	// within the name; empty ones pass everything) on the name of the family, the algorithm and the allocator of the cell,
+	// as printed by {ListCells}. {Primitives} (all if empty) restricts the element types of the container-based algorithms.
+	// With {SubtractBaseline}, the baseline is played even if filtered out. The concurrent game obeys {AlgorithmFilter} only.
+	//
+	std::string FamilyFilter;
+	std::string AlgorithmFilter;
+	std::string AllocatorFilter;
+	std::vector<std::string> Primitives;
+
+	// Only list the selected cells, without playing them.
+	//
+	bool ListCells{false};
+
+	// Every cell is measured at least {Repetitions} times. If {TargetRelativeCi} is set, the measurement is repeated
+	// until the 95% confidence interval of the mean gets narrower than that fraction of the mean,
+	// or until {MaxRepetitions} is reached (0 stands for 100, or {Repetitions} if greater).
+	//
+	int Repetitions{1};
+	int MaxRepetitions{0};
+	double TargetRelativeCi{0};
+
+	// If set, {Turns} is only the starting point: the number of turns is calibrated separately for every cell,
+	// so that a single run takes about {TargetCellMs} milliseconds (but no more than {MaxTurns} turns).
+	//
+	double TargetCellMs{0};
+	int MaxTurns{1 << 30};
+
+	// Generate all the slots before the measurement and replay them from memory, instead of running
+	// the pseudo-random generator inside of the measured loop.
+	//
+	bool PregenerateSlots{false};
+	bool HugePages{false};
+
+	// Back the chunks of slotallocmethod::ArenaAllocMethod with huge pages.
+	//
+	bool ArenaHugePages{false};
+
+	// Count the hardware events (perfcounters::eventNames) of every timed run, reported per turn along with the time.
+	// The events the host does not provide (typically all of them in a container) are reported as empty.
+	// The counts include the generator: {SubtractBaseline} applies to the time only.
+	//
+	bool PerfCounters{false};
+
+	// Profile the memory of every cell in an additional, untimed run (see MemoryProfile.h): the heap allocations and bytes
+	// allocated, the peak of the live heap bytes, the heap bytes per element held at the end (at the steady-state fill),
+	// and the growth of the peak resident set size (which is meaningful only when the cells are played one by one).
+	//
+	bool ProfileMemory{false};
+
+	// Subtract the median time per turn of the generator alone (the Tag<void> case of the same number of slots)
+	// from every sample, so that only the cost of the collection remains.
+	//
+	bool SubtractBaseline{false};
+
+	// The collections are played with DefaultUniformGenerator computed inside of the measured loop.
+	// Any other generator is used through pre-generated slots, except for the void case, which measures the generator itself
+	// (unless SubtractBaseline, which needs the void case to replay the same pre-generated slots as the cells do).
+	//
+	std::string Generator{DefaultUniformGenerator::Name()};
+
+	// Every cell is measured for each of the distributions. All but the uniform one are pre-generated,
+	// except for the traces ("trace:PATH"), which are decoded straight from the mapped file inside of the measured loop.
+	//
+	std::vector<std::string> Distributions{"uniform"};
+	DistributionParameters Shape; // Parameters of the non-uniform distributions.
+
+	// If set, no benchmark is run; instead {TraceTurns} slots of the first distribution (and the selected generator),
+	// over a space of {TraceSlots} slots, are recorded to a trace at {RecordTrace}.
+	//
+	std::string RecordTrace;
+	int64_t TraceTurns{0}; // 0 stands for {Turns}.
+	int TraceSlots{1024 * 1024};
+
+	// Up to {Jobs} cells (0 stands for one per core) are measured at once, each on its own pinned core, out of {Cores}
+	// (all the cores available to the process if empty). With the defaults, the cells run one by one on the main thread.
+	// {SkipSmtSiblings} leaves all but one logical processor of every physical core idle. {IsolateDriver} pins the main
+	// thread to the first of the cores and keeps the cells off it (and its SMT siblings).
+	// In the {NoisyNeighbours} mode, the cells are measured one by one, while all the other cores run copies of the same cell.
+	//
+	int Jobs{1};
+	std::vector<int> Cores;
+	bool SkipSmtSiblings{false};
+	bool IsolateDriver{false};
+	bool NoisyNeighbours{false};
+
+	// If set, only the concurrent game is played: {Threads} threads (by default, the powers of two up to the number
+	// of cores, and that number) share a collection of each of the {ConcurrentSlots} sizes, every thread playing {Turns} turns
+	// for the throughput and as many timed ones for the latencies, {ReadPercent} percent of which only look the slot up.
+	// The threads are pinned to {Cores}, like the cells.
+	//
+	bool Concurrent{false};
+	std::vector<int> Threads;
+	std::vector<int> ConcurrentSlots{1024, 64 * 1024, 1024 * 1024};
+	int ReadPercent{0};
+
+	// Besides the tables printed to the standard output, the results (with all the samples, the metadata of the host
+	// and {CommandLine}) are exported to each of the files given: CSV, JSON lines and the columnar binary format (ResultExport.h).
+	//
+	std::string ExportCsv;
+	std::string ExportJsonLines;
+	std::string ExportColumnar;
+	std::string CommandLine;
+};
+
+// Set by the entry point of the game being played, before anything is measured. Defined in Benchmark.cpp.
+//
+extern BenchmarkOptions benchmarkOptions;
+extern timer::Timer benchmarkTimer;
+
+// True if {name} passes the filter of the options (see BenchmarkOptions::FamilyFilter).
+//
+bool PassesFilter(const std::string& filter, const std::string& name);
+
+namespace resultexport
+{
+	struct ResultTable;
+}
+
+// Writes the results of the {game} to the files selected by the options (Benchmark.cpp).
+//
+void ExportResults(const BenchmarkOptions& options, const std::string& game, const resultexport::ResultTable& table);
+
+// Plays the multithreaded game (ConcurrentBenchmark.cpp).
+//
+void ConcurrentBenchmark(const BenchmarkOptions& options);
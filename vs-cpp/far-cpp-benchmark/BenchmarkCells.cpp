@@ -0,0 +1,57 @@
+
+#include "Pch.h"
+
+#include "Common.h"
+#include "MemoryProfile.h"
+#include "FindAddRemove.h"
+#include "Timer.h"
+#include "Statistics.h"
+#include "SlotStream.h"
+#include "RandomGenerators.h"
+#include "Distributions.h"
+#include "Trace.h"
+#include "PerfCounters.h"
+#include "Benchmark.h"
+#include "BenchmarkCells.h"
+
+namespace
+{
+	using namespace std::string_literals;
+
+	thread_local SlotBuffer slotBuffer;
+	std::map<std::string, std::unique_ptr<trace::MappedTrace>> mappedTraces; // By distribution.
+}
+
+std::vector<BenchmarkJob> benchmarkJobs;
+
+const trace::MappedTrace* FindTrace(const std::string& distribution)
+{
+	const auto tracePrefix = "trace:"s;
+	if (distribution.compare(0, tracePrefix.size(), tracePrefix) != 0) {
+		return nullptr;
+	}
+
+	auto finding = mappedTraces.find(distribution);
+	if (finding == std::end(mappedTraces)) {
+		finding = mappedTraces.emplace(distribution, std::make_unique<trace::MappedTrace>(distribution.substr(tracePrefix.size()))).first;
+	}
+	return finding->second.get();
+}
+
+const SlotValue* FillSlots(int turns, int slots, const std::string& distribution)
+{
+	slotBuffer.UseHugePages(benchmarkOptions.HugePages);
+
+	if (const auto mappedTrace = FindTrace(distribution)) {
+		return slotBuffer.Fill(turns, TraceReplayGenerator{*mappedTrace});
+	}
+	if (distribution != "uniform") {
+		return slotBuffer.Fill(turns, NonUniformDistributions().at(distribution)(slots, benchmarkOptions.Shape));
+	}
+
+	const SlotValue* slotStream{nullptr};
+	WithUniformGenerator(benchmarkOptions.Generator, slots, [&] (auto randomGenerator) {
+		slotStream = slotBuffer.Fill(turns, randomGenerator);
+	});
+	return slotStream;
+}
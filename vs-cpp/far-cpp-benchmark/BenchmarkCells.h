@@ -0,0 +1,307 @@
+#pragma once
+
+// Cells of the single-threaded benchmark and the registry of the algorithm families producing them.
+//
+// Every family lives in its own translation unit (Family*.cpp), which instantiates the games of its algorithms and registers
+// itself at startup through a RegisterBenchmarkFamily object. For every number of slots, the driver asks the families,
+// in the order of their ranks, to enqueue their cells.
+
+constexpr bool doWarmup{false};
+
+// Numbers of slots every family is played for, unless selected otherwise by the options.
+//
+using SlotsSeries = IntegerConstants<
+	2,
+	8,
+	64,
+	256,
+	1 * 1024,
+	4 * 1024,
+	16 * 1024,
+	64 * 1024,
+	256 * 1024,
+	1 * 1024 * 1024,
+	4 * 1024 * 1024
+	//16 * 1024 * 1024,
+	//64 * 1024 * 1024,
+	//256 * 1024 * 1024
+>;
+
+constexpr int maxSlotsForBitset{4 * 1024 * 1024};
+constexpr int maxSlotsForSequence{4 * 1024};
+constexpr int maxSlotsForSortedSearch{1 * 1024 * 1024};
+
+struct BenchmarkCell
+{
+	int Turns;
+	std::vector<double> TimePerTurnNs; // One sample per repetition, in the order of measurement.
+	SampleSummary Summary;
+	perfcounters::Counts CountsPerTurn; // Over all the repetitions; NaN unless counted (see BenchmarkOptions::PerfCounters).
+	memoryprofile::CellMemory Memory;
+	std::vector<double> ProbeLengths; // At the end of a run of its own (see ProfileProbeLengths()); empty unless counted.
+};
+
+// A measured cell, yet to be merged into the records.
+//
+struct CellResult
+{
+	int Slots;
+	bool IsBaseline;
+	std::string Distribution;
+	std::string Algorithm; // Human-readable (demangled) names of the types of the cell.
+	std::string Allocator;
+	std::string Primitive;
+	BenchmarkCell Cell;
+};
+
+// Every job measures one (slots, algorithm, allocator) cell for all the distributions.
+// The jobs share nothing mutable but the thread-local slot buffer, so they can run concurrently.
+//
+using BenchmarkJob = std::function<std::vector<CellResult>()>;
+
+// A family enqueues the cells of all its algorithms for the given number of slots.
+//
+using EnqueueFamilyFunction = void(*)(int turns, int slots);
+
+struct BenchmarkFamily
+{
+	int Rank; // The families are enqueued by rank, then by name; the baseline (rank 0) must go first.
+	std::string Name;
+	EnqueueFamilyFunction Enqueue;
+};
+
+// All the registered families, sorted.
+//
+inline std::vector<BenchmarkFamily>& BenchmarkFamilies()
+{
+	static std::vector<BenchmarkFamily> families;
+	return families;
+}
+
+struct RegisterBenchmarkFamily
+{
+	RegisterBenchmarkFamily(int rank, const char* name, EnqueueFamilyFunction enqueue)
+	{
+		auto& families = BenchmarkFamilies();
+		const auto family = BenchmarkFamily{rank, name, enqueue};
+		families.insert(std::upper_bound(std::begin(families), std::end(families), family, [] (const BenchmarkFamily& a, const BenchmarkFamily& b) {
+			return std::tie(a.Rank, a.Name) < std::tie(b.Rank, b.Name);
+		}), family);
+	}
+};
+
+// Defined in BenchmarkCells.cpp.
+//
+extern std::vector<BenchmarkJob> benchmarkJobs;
+
+// Returns the trace if {distribution} names one ("trace:PATH"), mapping it on the first use; nullptr otherwise.
+//
+// All the traces are mapped while the options are validated, so the jobs only ever look them up.
+//
+const trace::MappedTrace* FindTrace(const std::string& distribution);
+
+// Fills the buffer of the calling thread with {turns} slots of the distribution.
+//
+const SlotValue* FillSlots(int turns, int slots, const std::string& distribution);
+
+// The void case measures the selected generator itself, all the others play with the default one.
+//
+template<typename F, typename AlgorithmTag>
+void WithInLoopGenerator(int slots, AlgorithmTag, F f)
+{
+	f(DefaultUniformGenerator{slots});
+}
+
+template<typename F>
+void WithInLoopGenerator(int slots, Tag<void>, F f)
+{
+	WithUniformGenerator(benchmarkOptions.Generator, slots, f);
+}
+
+template<typename AlgorithmTag, typename AllocatorTag>
+BenchmarkCell Measure(int turns, int slots, const std::string& distribution, AlgorithmTag algorithmTag, AllocatorTag allocatorTag)
+{
+	// The counters of the thread are read around the timed run only.
+	//
+	const auto counters = benchmarkOptions.PerfCounters ? &perfcounters::ThreadCounterGroup() : nullptr;
+	auto runCounts = perfcounters::NotCounted();
+
+	// The allocations are counted in the profiling run only.
+	//
+	memoryprofile::AllocationStats* memoryStats{nullptr};
+	auto lastResult = GameResult{};
+
+	const auto play = [&] (int cellTurns, auto randomGenerator) {
+		const memoryprofile::CountAllocations counting{memoryStats};
+		if (counters != nullptr) {
+			counters->Start();
+		}
+		const auto ticks0 = benchmarkTimer.Start();
+		const auto result = PlayFindAddRemove(cellTurns, slots, randomGenerator, algorithmTag, allocatorTag);
+		const auto ticks1 = benchmarkTimer.Stop();
+		if (counters != nullptr) {
+			runCounts = counters->Stop();
+		}
+
+		const volatile auto averageFillRatio = GetRatioOf(result.SumOfSizes, {cellTurns}) / slots;
+		lastResult = result;
+		return benchmarkTimer.ElapsedNs(ticks0, ticks1);
+	};
+
+	// The baseline measures the selected generator inside of the loop, unless it is to be subtracted from the cells,
+	// which then must pay exactly what it does.
+	//
+	constexpr bool isBaseline{std::is_same<AlgorithmTag, Tag<void>>::value};
+	const auto mappedTrace = FindTrace(distribution);
+	const auto pregenerate = benchmarkOptions.PregenerateSlots || (mappedTrace == nullptr && (distribution != "uniform" ||
+		((!isBaseline || benchmarkOptions.SubtractBaseline) && benchmarkOptions.Generator != DefaultUniformGenerator::Name())));
+
+	// A trace cannot be played for longer than it lasts.
+	//
+	const auto maxTurns = mappedTrace != nullptr ? static_cast<int>(std::min<int64_t>(mappedTrace->Count(), benchmarkOptions.MaxTurns)) : benchmarkOptions.MaxTurns;
+
+	const auto measure = [&] (int cellTurns) {
+		double elapsedNs{0};
+		if (pregenerate) {
+			elapsedNs = play(cellTurns, StreamGenerator{FillSlots(cellTurns, slots, distribution)});
+		} else if (mappedTrace != nullptr) {
+			elapsedNs = play(cellTurns, TraceReplayGenerator{*mappedTrace});
+		} else {
+			WithInLoopGenerator(slots, algorithmTag, [&] (auto randomGenerator) {
+				elapsedNs = play(cellTurns, randomGenerator);
+			});
+		}
+		return elapsedNs;
+	};
+
+	// Calibrate the number of turns (in the manner of cpp-btree/btree_bench.cc), so that a run takes the target time.
+	// The calibration runs are discarded, serving as a warm-up.
+	//
+	auto cellTurns = std::min(turns, maxTurns);
+	if (benchmarkOptions.TargetCellMs > 0)
+	{
+		const auto targetNs = benchmarkOptions.TargetCellMs * 1e6;
+		for (;;)
+		{
+			const auto elapsedNs = measure(cellTurns);
+			if (elapsedNs >= targetNs || cellTurns >= maxTurns) {
+				break;
+			}
+
+			// Overshoot the estimate a little, so that the loop does not crawl towards the target,
+			// but do not trust a single tiny measurement too much either.
+			//
+			const auto growth = elapsedNs > 0 ? clamp(1.2 * targetNs / elapsedNs, 2.0, 100.0) : 100.0;
+			cellTurns = static_cast<int>(std::min(cellTurns * growth, static_cast<double>(maxTurns)));
+		}
+	}
+
+	// Run the workload (measuring the time), repeating it until the requested precision is reached.
+	//
+	auto cell = BenchmarkCell{cellTurns};
+	auto totalCounts = perfcounters::Counts{};
+	int64_t totalTurns{0};
+	for (;;)
+	{
+		cell.TimePerTurnNs.push_back(measure(cellTurns) / cellTurns);
+		for (int event{0}; event < perfcounters::events; ++event) {
+			totalCounts[event] += runCounts[event];
+		}
+		totalTurns += cellTurns;
+
+		const auto repetitions = static_cast<int>(cell.TimePerTurnNs.size());
+		if (repetitions < benchmarkOptions.Repetitions) {
+			continue;
+		}
+		if (benchmarkOptions.TargetRelativeCi <= 0 || repetitions >= benchmarkOptions.MaxRepetitions) {
+			break;
+		}
+		if (RelativeConfidenceHalfWidth(Summarize(cell.TimePerTurnNs)) * 2 <= benchmarkOptions.TargetRelativeCi) {
+			break;
+		}
+	}
+
+	for (int event{0}; event < perfcounters::events; ++event) {
+		cell.CountsPerTurn[event] = totalCounts[event] / static_cast<double>(totalTurns);
+	}
+
+	// Count the probe lengths in a run of their own, if the collection keeps track of them.
+	//
+	if (AlgorithmKeepsProbeLengths<AlgorithmTag>::value)
+	{
+		CountingProbeLengths() = true;
+		measure(cellTurns);
+		CountingProbeLengths() = false;
+
+		const auto& probeLengths = lastResult.FinalProbeLengths;
+		const auto counted = std::find_if(probeLengths.rbegin(), probeLengths.rend(), [] (int64_t n) { return n != 0; }).base();
+		cell.ProbeLengths.assign(std::begin(probeLengths), counted);
+	}
+
+	// Profile the memory in a run of its own, so that the counting does not slow the timed runs down.
+	//
+	if (benchmarkOptions.ProfileMemory)
+	{
+		auto stats = memoryprofile::AllocationStats{};
+		const auto peakReset = memoryprofile::ResetPeakResidentBytes();
+		const auto residentBytes = memoryprofile::ResidentBytes();
+
+		memoryStats = &stats;
+		measure(cellTurns);
+		memoryStats = nullptr;
+
+		cell.Memory.Allocations = stats.Allocations;
+		cell.Memory.BytesAllocated = stats.BytesAllocated;
+		cell.Memory.PeakLiveBytes = stats.PeakLiveBytes;
+		if (lastResult.FinalSize > 0) {
+			cell.Memory.BytesPerElement = static_cast<double>(lastResult.FinalLiveBytes) / static_cast<double>(lastResult.FinalSize);
+		}
+		if (peakReset && residentBytes >= 0) {
+			cell.Memory.PeakResidentGrowthBytes = memoryprofile::PeakResidentBytes() - residentBytes;
+		}
+	}
+	return cell;
+}
+
+// Enqueues the cell, to be measured by the driver, unless it is filtered out (or only to be listed).
+//
+template<typename AlgorithmTag, typename AllocatorTag>
+void Benchmark(int turns, int slots, AlgorithmTag algorithmTag, AllocatorTag allocatorTag)
+{
+	constexpr bool isBaseline{std::is_same<AlgorithmTag, Tag<void>>::value};
+	const auto algorithmName = TypeName(typeid(algorithmTag));
+	const auto allocatorName = TypeName(typeid(allocatorTag));
+
+	const auto selected = PassesFilter(benchmarkOptions.AlgorithmFilter, algorithmName) && PassesFilter(benchmarkOptions.AllocatorFilter, allocatorName);
+	if (!selected && !(isBaseline && benchmarkOptions.SubtractBaseline)) {
+		return;
+	}
+	if (benchmarkOptions.ListCells) {
+		std::cout << slots << sep << algorithmName << sep << allocatorName << std::endl;
+		return;
+	}
+
+	benchmarkJobs.push_back([=] {
+		// Warm up the code.
+		//
+		if (doWarmup) {
+			PlayFindAddRemove(turns, slots, DefaultUniformGenerator{std::max(slots / 8, 1)}, algorithmTag, allocatorTag);
+		}
+
+		const auto primitiveName = std::string{PrimitiveName(Tag<typename CellPrimitive<AllocatorTag>::type>{})};
+
+		std::vector<CellResult> results;
+		for (const auto& distribution : benchmarkOptions.Distributions)
+		{
+			// The slots of a trace must fit into the space.
+			//
+			const auto mappedTrace = FindTrace(distribution);
+			if (mappedTrace != nullptr && mappedTrace->Slots() > slots) {
+				continue;
+			}
+
+			results.push_back({slots, std::is_same<AlgorithmTag, Tag<void>>::value, distribution, algorithmName, allocatorName, primitiveName, Measure(turns, slots, distribution, algorithmTag, allocatorTag)});
+		}
+		return results;
+	});
+}
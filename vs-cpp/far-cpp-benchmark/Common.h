@@ -36,7 +36,7 @@ void ForEachNonVoidTag(Tag<T1, TX...>, F f)
 }
 
 template<typename F, typename... TX>
-void ForEachNonVoidTag(Tag<void, TX...>, F)
+void ForEachNonVoidTag(Tag<void, TX...>, F f)
 {
 	ForEachTag(Tag<TX...>{}, f);
 }
@@ -117,6 +117,65 @@ constexpr Type clamp(Type value, Type min, Type max)
 //	constexpr int128_t& operator^=(T v) { lo ^= v; return *this; }
 //};
 
+// Human-readable name of the type: typeid().name() is already readable with MSVC, but mangled with GCC and Clang.
+//
+inline std::string TypeName(const std::type_info& type)
+{
+#if defined(__GNUG__)
+	int status{0};
+	const auto demangled = std::unique_ptr<char, void(*)(void*)>{abi::__cxa_demangle(type.name(), nullptr, nullptr, &status), std::free};
+	if (status == 0 && demangled) {
+		return demangled.get();
+	}
+#endif
+	return type.name();
+}
+
+// Element types of the container-based algorithms.
+//
+using PrimitiveTypes = Tag<
+	int8_t,
+	uint8_t,
+	int16_t,
+	uint16_t,
+	int32_t,
+	uint32_t,
+	int64_t,
+	uint64_t
+	//intbig_t<128>
+>;
+
+// Names of the primitive types, as selected by the options and shown in the results.
+//
+inline const char* PrimitiveName(Tag<void>) { return ""; }
+inline const char* PrimitiveName(Tag<int8_t>) { return "int8_t"; }
+inline const char* PrimitiveName(Tag<uint8_t>) { return "uint8_t"; }
+inline const char* PrimitiveName(Tag<int16_t>) { return "int16_t"; }
+inline const char* PrimitiveName(Tag<uint16_t>) { return "uint16_t"; }
+inline const char* PrimitiveName(Tag<int32_t>) { return "int32_t"; }
+inline const char* PrimitiveName(Tag<uint32_t>) { return "uint32_t"; }
+inline const char* PrimitiveName(Tag<int64_t>) { return "int64_t"; }
+inline const char* PrimitiveName(Tag<uint64_t>) { return "uint64_t"; }
+template<typename T> std::string PrimitiveName(Tag<T>) { return TypeName(typeid(T)); }
+
+inline std::vector<std::string> PrimitiveNames()
+{
+	std::vector<std::string> names;
+	ForEachTag(PrimitiveTypes{}, [&] (auto primitiveTag) {
+		names.push_back(PrimitiveName(primitiveTag));
+	});
+	return names;
+}
+
+// Primitive type played by the cell, given the tag of its slot allocation method: the first template argument of the method
+// (every method is parameterized by the primitive type first), or void for the cells with no allocation method.
+//
+template<typename AllocatorTag>
+struct CellPrimitive { using type = void; };
+
+template<template<typename...> class AllocMethod, typename PrimitiveType, typename... Others>
+struct CellPrimitive<Tag<AllocMethod<PrimitiveType, Others...>>> { using type = PrimitiveType; };
+
 template<int bits, typename vtype = int64_t>
 struct intbig_t
 {
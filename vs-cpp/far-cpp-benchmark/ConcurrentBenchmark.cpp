@@ -0,0 +1,211 @@
+
+#include "Pch.h"
+
+#include "Common.h"
+#include "MemoryProfile.h"
+#include "FindAddRemove.h"
+#include "Timer.h"
+#include "Statistics.h"
+#include "RandomGenerators.h"
+#include "Distributions.h"
+#include "Scheduler.h"
+#include "LockFreeHashSet.h"
+#include "ShardedSet.h"
+#include "ConcurrentFindAddRemove.h"
+#include "ResultExport.h"
+#include "Benchmark.h"
+
+namespace
+{
+	struct ConcurrentRecord
+	{
+		int Threads;
+		int Slots;
+		std::string Sync;
+		std::string Algorithm;
+		std::vector<double> ThroughputMops; // One sample per repetition.
+		LatencyHistogram Latency; // Of all the repetitions.
+	};
+
+	std::vector<ConcurrentRecord> concurrentRecords;
+
+	template<typename AlgorithmTag, typename SyncPolicy>
+	void ConcurrentBenchmark(int threads, int slots, const std::vector<int>& cores, AlgorithmTag algorithmTag, Tag<SyncPolicy> syncPolicyTag)
+	{
+		if (!PassesFilter(benchmarkOptions.AlgorithmFilter, TypeName(typeid(algorithmTag)))) {
+			return;
+		}
+
+		std::cout << '.';
+		std::flush(std::cout);
+
+		auto record = ConcurrentRecord{threads, slots, SyncPolicy::Name(), TypeName(typeid(algorithmTag))};
+		for (int repetition{0}; repetition < benchmarkOptions.Repetitions; ++repetition)
+		{
+			const auto result = PlayConcurrentFindAddRemove(threads, benchmarkOptions.Turns, slots, benchmarkOptions.ReadPercent, cores, benchmarkTimer,
+				[slots] (int thread) { return DefaultUniformGenerator{slots, randomengine::defaultSeed + static_cast<uint64_t>(thread)}; },
+				algorithmTag, syncPolicyTag);
+
+			record.ThroughputMops.push_back(1e3 * static_cast<double>(result.Operations) / result.ElapsedNs);
+			record.Latency.Merge(result.Latency);
+		}
+		concurrentRecords.push_back(std::move(record));
+	}
+
+	// Locks guarding single slots cannot protect a set.
+	//
+	template<typename SetCollection, int Stripes>
+	void ConcurrentBenchmark(int, int, const std::vector<int>&, SetTag<SetCollection>, Tag<syncpolicy::StripedMutex<Stripes>>)
+	{
+	}
+}
+
+void ConcurrentBenchmark(const BenchmarkOptions& options)
+{
+	benchmarkOptions = options;
+	benchmarkTimer = timer::MakeTimer(options.Timer);
+
+	auto cores = options.Cores.empty() ? scheduler::AvailableCores() : options.Cores;
+	if (options.SkipSmtSiblings) {
+		cores = scheduler::WithoutSmtSiblings(cores);
+	}
+
+	auto threadCounts = options.Threads;
+	if (threadCounts.empty()) {
+		const auto maxThreads = static_cast<int>(cores.size());
+		for (int threads{1}; threads < maxThreads; threads *= 2) {
+			threadCounts.push_back(threads);
+		}
+		threadCounts.push_back(maxThreads);
+	}
+
+	std::cout << "The concurrent benchmark lets {threads} threads play " << options.Turns << " turns each on a shared {dataset} collection "
+		<< "guarded by {sync}, " << options.ReadPercent << "% of the turns being lookups only. " << nl
+		<< "Threads are pinned to cores";
+	for (const auto core : cores) {
+		std::cout << ' ' << core;
+	}
+	std::cout << ". The throughput is taken from an untimed run, the latency from another one, every operation of which is timed with "
+		<< benchmarkTimer.Name() << '.' << std::endl;
+	std::cout << "Processing...";
+
+	for (const auto slots : options.ConcurrentSlots)
+	{
+		for (const auto threads : threadCounts)
+		{
+			ForEachTag(Tag<
+				syncpolicy::GlobalMutex,
+				syncpolicy::SharedMutex,
+				syncpolicy::Spinlock,
+				syncpolicy::StripedMutex<64>
+			>{},
+				[&] (auto syncPolicyTag)
+			{
+				ForEachTag(Tag<
+					PositionalTag<std::unique_ptr<uint8_t[]>>,
+					SetTag<std::set<uint32_t>>,
+					SetTag<std::unordered_set<uint32_t>>,
+					SetTag<btree::btree_set<uint32_t>>,
+					SetTag<google::dense_hash_set<uint32_t>>,
+					SetTag<tsl::hopscotch_set<uint32_t>>
+				>{},
+					[&] (auto algorithmTagTag)
+				{
+					using AlgorithmTag = typename decltype(algorithmTagTag)::value_type;
+					ConcurrentBenchmark(threads, slots, cores, AlgorithmTag{}, syncPolicyTag);
+				});
+			});
+
+			// Collections which synchronize themselves.
+			// The keys are uint32_t only, as everywhere in this benchmark: what it measures is the contention, and every other
+			// key type would multiply its (threads, slots, sync) matrix again. The single-threaded "concurrent" family
+			// (FamilyConcurrentSets.cpp) plays these sets for every primitive type.
+			//
+			ForEachTag(Tag<
+				ConcurrentSetTag<LockFreeHashSet<uint32_t>>,
+				ConcurrentSetTag<ShardedSet<std::set<uint32_t>, 64>>,
+				ConcurrentSetTag<ShardedSet<std::unordered_set<uint32_t>, 64>>,
+				ConcurrentSetTag<ShardedSet<boost::container::flat_set<uint32_t>, 64>>,
+				ConcurrentSetTag<ShardedSet<stx::btree_set<uint32_t>, 64>>,
+				ConcurrentSetTag<ShardedSet<btree::btree_set<uint32_t>, 64>>,
+				ConcurrentSetTag<ShardedSet<google::sparse_hash_set<uint32_t>, 64>>,
+				ConcurrentSetTag<ShardedSet<google::dense_hash_set<uint32_t>, 64>>,
+				ConcurrentSetTag<ShardedSet<tsl::hopscotch_set<uint32_t>, 64>>
+			>{},
+				[&] (auto algorithmTagTag)
+			{
+				using AlgorithmTag = typename decltype(algorithmTagTag)::value_type;
+				ConcurrentBenchmark(threads, slots, cores, AlgorithmTag{}, Tag<syncpolicy::None>{});
+			});
+		}
+	}
+
+	std::cout << std::endl;
+
+	// Latencies are the upper bounds of the log2 buckets (in nanoseconds); the histogram lists the non-empty buckets as bound:count.
+	//
+	std::cout << "threads"
+		<< sep << "slots"
+		<< sep << "sync"
+		<< sep << "algorithm"
+		<< sep << "timer"
+		<< sep << "read_percent"
+		<< sep << "turns_per_thread"
+		<< sep << "throughput_mops"
+		<< sep << "p50_ns"
+		<< sep << "p90_ns"
+		<< sep << "p99_ns"
+		<< sep << "p999_ns"
+		<< sep << "latency_histogram"
+		<< std::endl;
+
+	for (const auto& cr : concurrentRecords)
+	{
+		std::cout << cr.Threads
+			<< sep << cr.Slots
+			<< sep << cr.Sync
+			<< sep << cr.Algorithm
+			<< sep << benchmarkTimer.Name()
+			<< sep << options.ReadPercent
+			<< sep << options.Turns
+			<< sep << Summarize(cr.ThroughputMops).Median
+			<< sep << cr.Latency.Percentile(50)
+			<< sep << cr.Latency.Percentile(90)
+			<< sep << cr.Latency.Percentile(99)
+			<< sep << cr.Latency.Percentile(99.9)
+			<< sep;
+
+		for (int bucket{0}; bucket < LatencyHistogram::buckets; ++bucket) {
+			if (cr.Latency.Counts[bucket] != 0) {
+				std::cout << std::ldexp(1.0, bucket) << ':' << cr.Latency.Counts[bucket] << ' ';
+			}
+		}
+		std::cout << std::endl;
+	}
+
+	// Along with all the samples of the throughput and the full histogram (the counts of all the buckets, by bucket).
+	//
+	auto table = resultexport::ResultTable{{
+		{"threads", resultexport::ColumnType::Integer},
+		{"slots", resultexport::ColumnType::Integer},
+		{"sync", resultexport::ColumnType::String},
+		{"algorithm", resultexport::ColumnType::String},
+		{"timer", resultexport::ColumnType::String},
+		{"read_percent", resultexport::ColumnType::Integer},
+		{"turns_per_thread", resultexport::ColumnType::Integer},
+		{"throughput_mops", resultexport::ColumnType::Real},
+		{"p50_ns", resultexport::ColumnType::Real},
+		{"p90_ns", resultexport::ColumnType::Real},
+		{"p99_ns", resultexport::ColumnType::Real},
+		{"p999_ns", resultexport::ColumnType::Real},
+		{"throughput_samples_mops", resultexport::ColumnType::RealList},
+		{"latency_histogram", resultexport::ColumnType::RealList}
+	}};
+	for (const auto& cr : concurrentRecords) {
+		const auto histogram = std::vector<double>(std::begin(cr.Latency.Counts), std::end(cr.Latency.Counts));
+		table.AddRow({cr.Threads, cr.Slots, cr.Sync, cr.Algorithm, benchmarkTimer.Name(), options.ReadPercent, options.Turns,
+			Summarize(cr.ThroughputMops).Median, cr.Latency.Percentile(50), cr.Latency.Percentile(90), cr.Latency.Percentile(99), cr.Latency.Percentile(99.9),
+			cr.ThroughputMops, histogram});
+	}
+	ExportResults(options, "concurrent", table);
+}
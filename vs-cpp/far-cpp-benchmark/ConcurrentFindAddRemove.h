@@ -0,0 +1,320 @@
+#pragma once
+
+// Multithreaded variant of the Find-Add-Remove game.
+//
+// {threads} threads share a single collection. Every turn a thread draws a slot from its own generator and either toggles it
+// (adds it if absent, removes it otherwise) or, in {readPercent} percent of the turns, only looks it up.
+// The threads play two phases on the same collection: the throughput is taken from the wall time of the first one, whose
+// operations are not timed, while in the second one every operation is timed separately, the latencies being collected
+// in log2 histograms. So the overhead of the timer (serializing the pipeline) does not count against the throughput.
+//
+// The collection is accessed through its ConcurrentAdapter, and guarded by the synchronization policy.
+
+struct LatencyHistogram
+{
+	// Bucket 0 counts the operations shorter than 1 ns, bucket {b} those within [2^(b-1), 2^b) ns.
+	//
+	static constexpr int buckets{48};
+	int64_t Counts[buckets]{};
+
+	void Add(double ns) noexcept
+	{
+		int exponent{0};
+		if (ns >= 1) {
+			std::frexp(ns, &exponent);
+		}
+		++Counts[std::min(exponent, buckets - 1)];
+	}
+
+	void Merge(const LatencyHistogram& other) noexcept
+	{
+		for (int bucket{0}; bucket < buckets; ++bucket) {
+			Counts[bucket] += other.Counts[bucket];
+		}
+	}
+
+	int64_t Total() const noexcept
+	{
+		int64_t total{0};
+		for (const auto count : Counts) {
+			total += count;
+		}
+		return total;
+	}
+
+	// Upper bound of the bucket holding the percentile, in nanoseconds.
+	//
+	double Percentile(double percentile) const noexcept
+	{
+		const auto threshold = percentile / 100.0 * static_cast<double>(Total());
+		int64_t cumulative{0};
+		for (int bucket{0}; bucket < buckets; ++bucket) {
+			cumulative += Counts[bucket];
+			if (cumulative > 0 && static_cast<double>(cumulative) >= threshold) {
+				return std::ldexp(1.0, bucket);
+			}
+		}
+		return std::ldexp(1.0, buckets - 1);
+	}
+};
+
+struct ConcurrentGameResult
+{
+	int64_t Operations;
+	double ElapsedNs; // Wall time of the untimed phase, from the moment all the threads are released to the moment the last one finishes.
+	LatencyHistogram Latency; // Of the timed phase, as many operations again.
+};
+
+namespace syncpolicy
+{
+	inline void CpuRelax() noexcept
+	{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		_mm_pause();
+#endif
+	}
+
+	// A policy guards the collection (or only the part of it holding the slot) while {f} runs.
+	// Exclusive() is used for modifications, Shared() for lookups.
+
+	class GlobalMutex
+	{
+		std::mutex mutex;
+	public:
+		static const char* Name() noexcept { return "mutex"; }
+
+		template<typename F> auto Exclusive(int64_t, F f) { std::lock_guard<std::mutex> lock{mutex}; return f(); }
+		template<typename F> auto Shared(int64_t, F f) { std::lock_guard<std::mutex> lock{mutex}; return f(); }
+	};
+
+	class SharedMutex
+	{
+		std::shared_mutex mutex;
+	public:
+		static const char* Name() noexcept { return "shared_mutex"; }
+
+		template<typename F> auto Exclusive(int64_t, F f) { std::unique_lock<std::shared_mutex> lock{mutex}; return f(); }
+		template<typename F> auto Shared(int64_t, F f) { std::shared_lock<std::shared_mutex> lock{mutex}; return f(); }
+	};
+
+	// Test-and-test-and-set spinlock, backing off exponentially (up to {maxSpins} pauses) while the lock is taken.
+	//
+	class Spinlock
+	{
+		static constexpr int maxSpins{1024};
+		alignas(64) std::atomic<bool> locked{false};
+
+		void Lock() noexcept
+		{
+			int spins{1};
+			while (locked.exchange(true, std::memory_order_acquire)) {
+				while (locked.load(std::memory_order_relaxed)) {
+					for (int spin{0}; spin < spins; ++spin) {
+						CpuRelax();
+					}
+					spins = std::min(spins * 2, maxSpins);
+				}
+			}
+		}
+
+		void Unlock() noexcept { locked.store(false, std::memory_order_release); }
+
+	public:
+		static const char* Name() noexcept { return "spinlock"; }
+
+		template<typename F> auto Exclusive(int64_t, F f)
+		{
+			Lock();
+			const auto unlock = Finalize([this] { Unlock(); });
+			return f();
+		}
+
+		template<typename F> auto Shared(int64_t slot, F f) { return Exclusive(slot, f); }
+	};
+
+	// {Stripes} mutexes, each on its own cache line, guarding the slots congruent modulo {Stripes}.
+	// Only valid for collections whose slots are independent memory locations, i.e. the positional ones.
+	//
+	template<int Stripes>
+	class StripedMutex
+	{
+		struct alignas(64) Stripe
+		{
+			std::mutex Mutex;
+		};
+		std::unique_ptr<Stripe[]> stripes{std::make_unique<Stripe[]>(Stripes)};
+
+	public:
+		static const char* Name()
+		{
+			static const auto name = "striped" + std::to_string(Stripes);
+			return name.c_str();
+		}
+
+		template<typename F> auto Exclusive(int64_t slot, F f)
+		{
+			std::lock_guard<std::mutex> lock{stripes[static_cast<size_t>(slot % Stripes)].Mutex};
+			return f();
+		}
+
+		template<typename F> auto Shared(int64_t slot, F f) { return Exclusive(slot, f); }
+	};
+
+	// For the collections which synchronize themselves.
+	//
+	class None
+	{
+	public:
+		static const char* Name() noexcept { return "none"; }
+
+		template<typename F> auto Exclusive(int64_t, F f) { return f(); }
+		template<typename F> auto Shared(int64_t, F f) { return f(); }
+	};
+}
+
+// The collection of the concurrent game, for the given algorithm. Find() and Toggle() rely on the caller for synchronization.
+//
+template<typename AlgorithmTag>
+class ConcurrentAdapter;
+
+template<typename ElementType>
+class ConcurrentAdapter<PositionalTag<std::unique_ptr<ElementType[]>>>
+{
+	std::unique_ptr<ElementType[]> collection;
+public:
+	explicit ConcurrentAdapter(int slots) : collection{std::make_unique<ElementType[]>(slots)} {}
+
+	bool Find(int64_t slot) const { return collection[static_cast<size_t>(slot)] != 0; }
+	void Toggle(int64_t slot) { collection[static_cast<size_t>(slot)] ^= 1; }
+};
+
+template<typename SetCollection>
+class ConcurrentAdapter<SetTag<SetCollection>>
+{
+	using PrimitiveType = typename SetCollection::value_type;
+
+	SetCollection collection;
+	decltype(InitCollection(std::declval<SetCollection&>())) collectionAux{InitCollection(collection)};
+
+public:
+	explicit ConcurrentAdapter(int) {}
+
+	bool Find(int64_t slot) const { return collection.find(static_cast<PrimitiveType>(slot)) != collection.end(); }
+
+	void Toggle(int64_t slot)
+	{
+		auto insertion{collection.insert(static_cast<PrimitiveType>(slot))};
+		if (!insertion.second) {
+			collection.erase(insertion.first);
+		}
+	}
+};
+
+template<typename ConcurrentSet>
+class ConcurrentAdapter<ConcurrentSetTag<ConcurrentSet>>
+{
+	using PrimitiveType = typename ConcurrentSet::value_type;
+
+	ConcurrentSet collection;
+
+public:
+	explicit ConcurrentAdapter(int) {}
+
+	bool Find(int64_t slot) { return collection.contains(static_cast<PrimitiveType>(slot)); }
+	void Toggle(int64_t slot) { collection.toggle(static_cast<PrimitiveType>(slot)); }
+};
+
+// Locks guarding single slots cannot protect the shared structure of a set.
+//
+template<typename RandomGeneratorFactory, typename SetCollection, int Stripes>
+ConcurrentGameResult PlayConcurrentFindAddRemove(int threads, int turns, int slots, int readPercent, const std::vector<int>& cores, const timer::Timer& timer,
+	RandomGeneratorFactory makeRandomGenerator, SetTag<SetCollection>, Tag<syncpolicy::StripedMutex<Stripes>>) = delete;
+
+// Every thread plays {turns} turns, pinned to one of the {cores} (round-robin, unless the list is empty).
+// {makeRandomGenerator} is called with the index of the thread, so that every thread gets its own sequence.
+//
+template<typename RandomGeneratorFactory, typename AlgorithmTag, typename SyncPolicy>
+ConcurrentGameResult PlayConcurrentFindAddRemove(int threads, int turns, int slots, int readPercent, const std::vector<int>& cores, const timer::Timer& timer,
+	RandomGeneratorFactory makeRandomGenerator, AlgorithmTag, Tag<SyncPolicy>)
+{
+	ConcurrentAdapter<AlgorithmTag> collection{slots};
+	SyncPolicy sync;
+
+	std::vector<LatencyHistogram> histograms(static_cast<size_t>(threads));
+	std::vector<std::chrono::steady_clock::time_point> finishes(static_cast<size_t>(threads));
+	std::atomic<int> ready{0}; // Incremented by every thread before each of the phases.
+	std::atomic<int> released{0}; // The number of the phases started.
+
+	const auto await = [&] (int phase)
+	{
+		++ready;
+		while (released.load(std::memory_order_acquire) < phase) {
+			syncpolicy::CpuRelax();
+		}
+	};
+
+	const auto play = [&] (int thread)
+	{
+		if (!cores.empty()) {
+			scheduler::PinCurrentThread(cores[static_cast<size_t>(thread) % cores.size()]);
+		}
+
+		auto randomGenerator = makeRandomGenerator(thread);
+		auto readEngine = randomengine::WyRand{randomengine::defaultSeed + static_cast<uint64_t>(thread)};
+		auto histogram = LatencyHistogram{};
+
+		volatile bool found{false};
+		const auto operate = [&]
+		{
+			const auto slot = randomGenerator();
+			if (static_cast<int>(randomengine::BoundedRange(readEngine(), 100)) < readPercent) {
+				found = sync.Shared(slot, [&] { return collection.Find(slot); });
+			} else {
+				sync.Exclusive(slot, [&] { collection.Toggle(slot); });
+			}
+		};
+
+		await(1);
+		for (int turn{0}; turn < turns; ++turn) {
+			operate();
+		}
+		finishes[static_cast<size_t>(thread)] = std::chrono::steady_clock::now();
+
+		await(2);
+		for (int turn{0}; turn < turns; ++turn)
+		{
+			const auto ticks0 = timer.Start();
+			operate();
+			const auto ticks1 = timer.Stop();
+			histogram.Add(timer.ElapsedNs(ticks0, ticks1));
+		}
+
+		histograms[static_cast<size_t>(thread)] = histogram;
+	};
+
+	std::vector<std::thread> workers;
+	for (int thread{0}; thread < threads; ++thread) {
+		workers.emplace_back(play, thread);
+	}
+	while (ready != threads) {
+		std::this_thread::yield();
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	released.store(1, std::memory_order_release);
+	while (ready != 2 * threads) {
+		std::this_thread::yield();
+	}
+	const auto elapsed = *std::max_element(std::begin(finishes), std::end(finishes)) - start;
+
+	released.store(2, std::memory_order_release);
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	auto result = ConcurrentGameResult{int64_t{threads} * turns, std::chrono::duration<double, std::nano>{elapsed}.count()};
+	for (const auto& histogram : histograms) {
+		result.Latency.Merge(histogram);
+	}
+	return result;
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+// Non-uniform slot distributions.
+//
+// These are always fed to the game through pre-generated slots (see SlotStream.h), so their cost - some of them
+// involve a logarithm or two per sample - never lands inside the measured loop.
+// Like the uniform generators, they yield slots within the range from 1 to {slots}-1.
+
+struct DistributionParameters
+{
+	double ZipfTheta{0.99};      // Exponent of the Zipf distribution (positive); the larger, the more skewed.
+	double HotFraction{0.1};     // Share of the slots which make up the hot set, within (0, 1]...
+	double HotProbability{0.9};  // ...and the share of the turns which hit it, within [0, 1].
+	double WindowFraction{1.0 / 64}; // Width of the sliding window, relative to the number of slots.
+	int Clusters{16};            // Number of Gaussian clusters...
+	double ClusterSigmaFraction{1.0 / 256}; // ...and their standard deviation, relative to the number of slots.
+	int Jitter{8};               // Maximal distance of a monotonic slot from the turn counter.
+};
+
+namespace distribution
+{
+	using Engine = randomengine::Xoshiro256PlusPlus;
+
+	// Wraps any integer onto the range from 1 to {keys}.
+	//
+	inline int64_t WrapKey(int64_t value, int64_t keys) noexcept
+	{
+		const auto remainder = value % keys;
+		return 1 + (remainder < 0 ? remainder + keys : remainder);
+	}
+
+	// Zipf distribution over the ranks from 1 to {slots}-1, rank 1 being the most frequent.
+	//
+	// Uses rejection-inversion sampling (W. Hörmann, G. Derflinger: "Rejection-inversion to generate variates from
+	// monotone discrete distributions", 1996), which needs no table and takes constant expected time for any exponent.
+	//
+	// If {Scrambled}, the ranks are spread over the key space by a multiplicative permutation, so that the hot keys
+	// are not neighbours (as in YCSB's scrambled Zipfian); otherwise the hottest key is 1, the next is 2 and so on.
+	//
+	template<bool Scrambled>
+	class ZipfGenerator
+	{
+		Engine engine;
+		int64_t keys;
+		double exponent;
+		double hIntegralX1;
+		double hIntegralNumberOfElements;
+		double s;
+
+		static double Helper1(double x) noexcept
+		{
+			return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+		}
+
+		static double Helper2(double x) noexcept
+		{
+			return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x * 1.0 / 3 * (1 + 0.25 * x));
+		}
+
+		double H(double x) const noexcept
+		{
+			return std::exp(-exponent * std::log(x));
+		}
+
+		double HIntegral(double x) const noexcept
+		{
+			const auto logX = std::log(x);
+			return Helper2((1 - exponent) * logX) * logX;
+		}
+
+		double HIntegralInverse(double x) const noexcept
+		{
+			auto t = x * (1 - exponent);
+			if (t < -1) {
+				t = -1;
+			}
+			return std::exp(Helper1(t) * x);
+		}
+
+	public:
+		static const char* Name() noexcept { return Scrambled ? "scrambled-zipf" : "zipf"; }
+
+		ZipfGenerator(int slots, const DistributionParameters& parameters) :
+			keys{std::max(slots - 1, 1)},
+			exponent{parameters.ZipfTheta}
+		{
+			hIntegralX1 = HIntegral(1.5) - 1;
+			hIntegralNumberOfElements = HIntegral(static_cast<double>(keys) + 0.5);
+			s = 2 - HIntegralInverse(HIntegral(2.5) - H(2));
+		}
+
+		int64_t operator()()
+		{
+			for (;;)
+			{
+				const auto u = hIntegralNumberOfElements + randomengine::UniformReal(engine) * (hIntegralX1 - hIntegralNumberOfElements);
+				const auto x = HIntegralInverse(u);
+				const auto rank = clamp(static_cast<int64_t>(x + 0.5), int64_t{1}, keys);
+
+				if (static_cast<double>(rank) - x <= s || u >= HIntegral(static_cast<double>(rank) + 0.5) - H(static_cast<double>(rank))) {
+					// 2654435761 is a prime greater than any number of keys, so the multiplication permutes the ranks.
+					return Scrambled ? 1 + (rank - 1) * int64_t{2654435761} % keys : rank;
+				}
+			}
+		}
+	};
+
+	// {HotProbability} of the turns pick uniformly from the first {HotFraction} of the slots, the rest from the others.
+	//
+	class HotSetGenerator
+	{
+		Engine engine;
+		uint64_t hotKeys;
+		uint64_t coldKeys;
+		uint64_t hotThreshold;
+
+	public:
+		static const char* Name() noexcept { return "hot-set"; }
+
+		HotSetGenerator(int slots, const DistributionParameters& parameters)
+		{
+			const auto keys = static_cast<uint64_t>(std::max(slots - 1, 1));
+			hotKeys = clamp(static_cast<uint64_t>(static_cast<double>(keys) * parameters.HotFraction), uint64_t{1}, keys);
+			coldKeys = keys - hotKeys;
+			hotThreshold = parameters.HotProbability < 1 ? static_cast<uint64_t>(parameters.HotProbability * 18446744073709551616.0) : ~uint64_t{0};
+		}
+
+		int64_t operator()()
+		{
+			if (engine() <= hotThreshold || coldKeys == 0) {
+				return 1 + static_cast<int64_t>(randomengine::BoundedRange(engine(), hotKeys));
+			}
+			return 1 + static_cast<int64_t>(hotKeys + randomengine::BoundedRange(engine(), coldKeys));
+		}
+	};
+
+	// A window of {WindowFraction} of the slots advances by one slot every turn, wrapping around at the end;
+	// the slot is picked uniformly from within the window.
+	//
+	class SlidingWindowGenerator
+	{
+		Engine engine;
+		int64_t keys;
+		uint64_t window;
+		int64_t position{0};
+
+	public:
+		static const char* Name() noexcept { return "sliding-window"; }
+
+		SlidingWindowGenerator(int slots, const DistributionParameters& parameters) :
+			keys{std::max(slots - 1, 1)},
+			window{std::max(static_cast<uint64_t>(static_cast<double>(keys) * parameters.WindowFraction), uint64_t{1})}
+		{
+		}
+
+		int64_t operator()()
+		{
+			const auto offset = static_cast<int64_t>(randomengine::BoundedRange(engine(), window));
+			return WrapKey(position++ + offset, keys);
+		}
+	};
+
+	// Slots concentrate normally around {Clusters} centers placed uniformly over the key space.
+	//
+	class ClusteredGaussianGenerator
+	{
+		Engine engine;
+		int64_t keys;
+		std::vector<double> centers;
+		std::normal_distribution<double> deviation;
+
+	public:
+		static const char* Name() noexcept { return "clustered-gaussian"; }
+
+		ClusteredGaussianGenerator(int slots, const DistributionParameters& parameters) :
+			keys{std::max(slots - 1, 1)},
+			deviation{0.0, std::max(static_cast<double>(keys) * parameters.ClusterSigmaFraction, 0.5)}
+		{
+			for (int cluster{0}; cluster < std::max(parameters.Clusters, 1); ++cluster) {
+				centers.push_back(randomengine::UniformReal(engine) * static_cast<double>(keys));
+			}
+		}
+
+		int64_t operator()()
+		{
+			const auto& center = centers[static_cast<size_t>(randomengine::BoundedRange(engine(), centers.size()))];
+			return WrapKey(static_cast<int64_t>(std::floor(center + deviation(engine))), keys);
+		}
+	};
+
+	// Slots follow the turn counter (wrapping around at the end), each off by up to {Jitter} slots either way.
+	//
+	class MonotonicJitterGenerator
+	{
+		Engine engine;
+		int64_t keys;
+		int64_t jitter;
+		int64_t position{0};
+
+	public:
+		static const char* Name() noexcept { return "monotonic-jitter"; }
+
+		MonotonicJitterGenerator(int slots, const DistributionParameters& parameters) :
+			keys{std::max(slots - 1, 1)},
+			jitter{std::max(parameters.Jitter, 0)}
+		{
+		}
+
+		int64_t operator()()
+		{
+			const auto offset = static_cast<int64_t>(randomengine::BoundedRange(engine(), static_cast<uint64_t>(2 * jitter + 1))) - jitter;
+			return WrapKey(position++ + offset, keys);
+		}
+	};
+
+	// Type-erased, as the generators are only ever run outside of the measured loop.
+	//
+	using GeneratorFunction = std::function<int64_t()>;
+	using GeneratorFactory = GeneratorFunction (*)(int slots, const DistributionParameters&);
+
+	template<typename Generator>
+	GeneratorFunction MakeGenerator(int slots, const DistributionParameters& parameters)
+	{
+		return Generator{slots, parameters};
+	}
+}
+
+// Registry of the non-uniform distributions, by name. The uniform distribution is special, as it depends on the selected
+// generator, and is not listed here.
+//
+inline const std::map<std::string, distribution::GeneratorFactory>& NonUniformDistributions()
+{
+	static const std::map<std::string, distribution::GeneratorFactory> distributions = [] {
+		std::map<std::string, distribution::GeneratorFactory> registry;
+		ForEachTag(Tag<
+			distribution::ZipfGenerator<false>,
+			distribution::ZipfGenerator<true>,
+			distribution::HotSetGenerator,
+			distribution::SlidingWindowGenerator,
+			distribution::ClusteredGaussianGenerator,
+			distribution::MonotonicJitterGenerator
+		>{},
+			[&] (auto generatorTag)
+		{
+			using GeneratorType = typename decltype(generatorTag)::value_type;
+			registry.emplace(GeneratorType::Name(), &distribution::MakeGenerator<GeneratorType>);
+		});
+		return registry;
+	}();
+	return distributions;
+}
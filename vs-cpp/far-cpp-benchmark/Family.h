@@ -0,0 +1,20 @@
+#pragma once
+
+// The headers every algorithm family (Family*.cpp, see BenchmarkCells.h) is compiled with, in the order they depend on
+// each other. A family includes the headers of its own collections after this one.
+
+#include "Common.h"
+#include "MemoryProfile.h"
+#include "FindAddRemove.h"
+#include "Timer.h"
+#include "Statistics.h"
+#include "SlotStream.h"
+#include "RandomGenerators.h"
+#include "Distributions.h"
+#include "Trace.h"
+#include "PerfCounters.h"
+#include "Benchmark.h"
+#include "BenchmarkCells.h"
+#include "SlabAllocator.h"
+#include "PmrResources.h"
+#include "SlotAllocMethods.h"
@@ -0,0 +1,16 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// void is special - it only invokes the pseudo-random generator.
+	//
+	void EnqueueBaseline(int turns, int slots)
+	{
+		Benchmark(turns, slots, Tag<void>{}, Tag<void>{});
+	}
+
+	const RegisterBenchmarkFamily registration{0, "void", EnqueueBaseline};
+}
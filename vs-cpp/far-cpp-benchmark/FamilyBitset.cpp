@@ -0,0 +1,21 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// The size of std::bitset is a compile-time constant, so the bitset is only available for the numbers of slots of the series.
+	//
+	void EnqueueBitset(int turns, int slots)
+	{
+		ForEachIntegerConstant(SlotsSeries{}, [=] (auto seriesSlots)
+		{
+			if (seriesSlots.value() == slots && seriesSlots.value() <= maxSlotsForBitset) {
+				Benchmark(turns, slots, PositionalTag<std::bitset<seriesSlots.value()>>{}, Tag<void>{});
+			}
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{11, "std::bitset", EnqueueBitset};
+}
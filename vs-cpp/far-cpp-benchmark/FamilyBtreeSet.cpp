@@ -0,0 +1,23 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// Nodes of 256 bytes.
+	//
+	void EnqueueBtreeSet(int turns, int slots)
+	{
+		ForEachSlotAllocMethod(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SetTag<btree::btree_set<ElementType, typename SlotAllocType::Less, CollectionAllocatorType, 256>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{44, "btree::btree_set", EnqueueBtreeSet};
+}
@@ -0,0 +1,53 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+#include "LockFreeHashSet.h"
+#include "ShardedSet.h"
+
+namespace
+{
+	// LockFreeHashSet takes keys up to 32 bits wide only.
+	//
+	template<typename PrimitiveType>
+	void EnqueueLockFreeHashSet(int turns, int slots, std::true_type)
+	{
+		Benchmark(turns, slots, ConcurrentSetTag<LockFreeHashSet<PrimitiveType>>{}, Tag<PrimitiveAllocMethod<PrimitiveType>>{});
+	}
+
+	template<typename PrimitiveType>
+	void EnqueueLockFreeHashSet(int, int, std::false_type)
+	{ }
+
+	// Concurrent collections, played by a single thread here, to show what the concurrency safety costs.
+	// The concurrent sets hold the keys by value, so they are played for every primitive type, but with no other slot
+	// allocation method. ShardedSet wraps every set container with find(), i.e. all but SwissSet and RobinHoodSet.
+	//
+	void EnqueueConcurrentSets(int turns, int slots)
+	{
+		ForEachPrimitiveType(slots, [=] (auto primitiveTag)
+		{
+			using PrimitiveType = typename decltype(primitiveTag)::value_type;
+
+			EnqueueLockFreeHashSet<PrimitiveType>(turns, slots, std::integral_constant<bool, sizeof(PrimitiveType) <= 4>{});
+
+			ForEachTag(Tag<
+				ConcurrentSetTag<ShardedSet<std::set<PrimitiveType>, 64>>,
+				ConcurrentSetTag<ShardedSet<std::unordered_set<PrimitiveType>, 64>>,
+				ConcurrentSetTag<ShardedSet<boost::container::flat_set<PrimitiveType>, 64>>,
+				ConcurrentSetTag<ShardedSet<stx::btree_set<PrimitiveType>, 64>>,
+				ConcurrentSetTag<ShardedSet<btree::btree_set<PrimitiveType>, 64>>,
+				ConcurrentSetTag<ShardedSet<google::sparse_hash_set<PrimitiveType>, 64>>,
+				ConcurrentSetTag<ShardedSet<google::dense_hash_set<PrimitiveType>, 64>>,
+				ConcurrentSetTag<ShardedSet<tsl::hopscotch_set<PrimitiveType>, 64>>
+			>{},
+				[=] (auto algorithmTagTag)
+			{
+				using AlgorithmTag = typename decltype(algorithmTagTag)::value_type;
+				Benchmark(turns, slots, AlgorithmTag{}, Tag<PrimitiveAllocMethod<PrimitiveType>>{});
+			});
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{20, "concurrent", EnqueueConcurrentSets};
+}
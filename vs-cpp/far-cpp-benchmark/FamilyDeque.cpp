@@ -0,0 +1,28 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// Sequence-based algorithms, unsorted and sorted.
+	// When there are many slots, these work too slowly to be included in benchmark.
+	//
+	void EnqueueDeque(int turns, int slots)
+	{
+		if (slots > maxSlotsForSequence) {
+			return;
+		}
+
+		ForEachSlotAllocMethod(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using ElementType = typename decltype(slotAllocTag)::value_type::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SequenceUnsortedTag<std::deque<ElementType, CollectionAllocatorType>>{}, slotAllocTag);
+			Benchmark(turns, slots, SequenceSortedTag<std::deque<ElementType, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{31, "std::deque", EnqueueDeque};
+}
@@ -0,0 +1,21 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	void EnqueueFlatSet(int turns, int slots)
+	{
+		ForEachSlotAllocMethod(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SetTag<boost::container::flat_set<ElementType, typename SlotAllocType::Less, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{42, "boost::container::flat_set", EnqueueFlatSet};
+}
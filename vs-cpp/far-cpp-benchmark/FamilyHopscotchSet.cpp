@@ -0,0 +1,23 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// Neighborhoods of 62 buckets, growing by a factor of 2.
+	//
+	void EnqueueHopscotchSet(int turns, int slots)
+	{
+		ForEachSlotAllocMethod(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SetTag<tsl::hopscotch_set<ElementType, typename SlotAllocType::Hash, typename SlotAllocType::Equal, CollectionAllocatorType, 62U, std::ratio<2, 1>>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{47, "tsl::hopscotch_set", EnqueueHopscotchSet};
+}
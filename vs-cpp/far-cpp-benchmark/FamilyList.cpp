@@ -0,0 +1,28 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// Sequence-based algorithms, unsorted and sorted.
+	// When there are many slots, these work too slowly to be included in benchmark.
+	//
+	void EnqueueList(int turns, int slots)
+	{
+		if (slots > maxSlotsForSequence) {
+			return;
+		}
+
+		ForEachSlotAllocMethod<NodeCollectionAllocators>(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using ElementType = typename decltype(slotAllocTag)::value_type::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SequenceUnsortedTag<std::list<ElementType, CollectionAllocatorType>>{}, slotAllocTag);
+			Benchmark(turns, slots, SequenceSortedTag<std::list<ElementType, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{32, "std::list", EnqueueList};
+}
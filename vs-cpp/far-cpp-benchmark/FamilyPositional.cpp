@@ -0,0 +1,39 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// In positional algorithm, slot is determined by the position (index) in a pre-allocated space.
+	//
+	void EnqueuePositional(int turns, int slots)
+	{
+		ForEachTag(Tag<
+			PositionalTag<std::unique_ptr<bool[]>, uint8_t>,
+			PositionalTag<std::unique_ptr<bool[]>, int8_t>,
+			PositionalTag<std::unique_ptr<bool[]>, uint16_t>,
+			PositionalTag<std::unique_ptr<bool[]>, int16_t>,
+			PositionalTag<std::unique_ptr<bool[]>, uint32_t>,
+			PositionalTag<std::unique_ptr<bool[]>, int32_t>,
+			PositionalTag<std::unique_ptr<bool[]>, uint64_t>,
+			PositionalTag<std::unique_ptr<bool[]>, int64_t>,
+			PositionalTag<std::unique_ptr<uint8_t[]>>,
+			PositionalTag<std::unique_ptr<int8_t[]>>,
+			PositionalTag<std::unique_ptr<uint16_t[]>>,
+			PositionalTag<std::unique_ptr<int16_t[]>>,
+			PositionalTag<std::unique_ptr<uint32_t[]>>,
+			PositionalTag<std::unique_ptr<int32_t[]>>,
+			PositionalTag<std::unique_ptr<uint64_t[]>>,
+			PositionalTag<std::unique_ptr<int64_t[]>>,
+			PositionalTag<std::vector<bool>>
+		>{},
+			[=] (auto algorithmTagTag)
+		{
+			using AlgorithmTag = typename decltype(algorithmTagTag)::value_type;
+			Benchmark(turns, slots, AlgorithmTag{}, Tag<void>{});
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{10, "positional", EnqueuePositional};
+}
@@ -0,0 +1,22 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+#include "RobinHood.h"
+
+namespace
+{
+	void EnqueueRobinHoodSet(int turns, int slots)
+	{
+		ForEachSlotAllocMethod(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SetTag<robinhood::RobinHoodSet<ElementType, typename SlotAllocType::Hash, typename SlotAllocType::Equal, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{49, "robinhood::RobinHoodSet", EnqueueRobinHoodSet};
+}
@@ -0,0 +1,33 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+#include "SimdSearch.h"
+#include "SortedSearch.h"
+#include "PackedMemoryArray.h"
+
+namespace
+{
+	// Sorted sequences of the slots themselves, searched by faster engines and indexed incrementally (see SortedSearch.h),
+	// or kept with gaps (see PackedMemoryArray.h), which lets them be played with far more slots than the plain sorted sequences.
+	//
+	void EnqueueSortedSearch(int turns, int slots)
+	{
+		if (slots > maxSlotsForSortedSearch) {
+			return;
+		}
+
+		ForEachPrimitiveType(slots, [=] (auto primitiveTag)
+		{
+			using PrimitiveType = typename decltype(primitiveTag)::value_type;
+			using SlotAllocTag = Tag<PrimitiveAllocMethod<PrimitiveType>>;
+
+			Benchmark(turns, slots, SetTag<sortedsearch::SortedSet<PrimitiveType, sortedsearch::BranchlessSearch>>{}, SlotAllocTag{});
+			Benchmark(turns, slots, SetTag<sortedsearch::SortedSet<PrimitiveType, sortedsearch::EytzingerSearch>>{}, SlotAllocTag{});
+			Benchmark(turns, slots, SetTag<sortedsearch::SortedSet<PrimitiveType, sortedsearch::STreeSearch>>{}, SlotAllocTag{});
+			Benchmark(turns, slots, SetTag<packedmemoryarray::PackedMemoryArray<PrimitiveType>>{}, SlotAllocTag{});
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{33, "sorted search", EnqueueSortedSearch};
+}
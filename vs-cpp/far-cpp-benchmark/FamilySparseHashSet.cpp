@@ -0,0 +1,23 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// The deleted key is reserved by InitCollection() (FindAddRemove.h).
+	//
+	void EnqueueSparseHashSet(int turns, int slots)
+	{
+		ForEachSlotAllocMethod(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SetTag<google::sparse_hash_set<ElementType, typename SlotAllocType::Hash, typename SlotAllocType::Equal, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{45, "google::sparse_hash_set", EnqueueSparseHashSet};
+}
@@ -0,0 +1,23 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// A node per element, so it is played with the slab allocator as well.
+	//
+	void EnqueueStdSet(int turns, int slots)
+	{
+		ForEachSlotAllocMethod<NodeCollectionAllocators>(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SetTag<std::set<ElementType, typename SlotAllocType::Less, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{40, "std::set", EnqueueStdSet};
+}
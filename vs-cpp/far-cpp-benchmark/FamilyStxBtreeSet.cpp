@@ -0,0 +1,21 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	void EnqueueStxBtreeSet(int turns, int slots)
+	{
+		ForEachSlotAllocMethod(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SetTag<stx::btree_set<ElementType, typename SlotAllocType::Less, stx::btree_default_set_traits<ElementType>, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{43, "stx::btree_set", EnqueueStxBtreeSet};
+}
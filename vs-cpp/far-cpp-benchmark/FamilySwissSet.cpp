@@ -0,0 +1,23 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+#include "SimdSearch.h"
+#include "SwissTable.h"
+
+namespace
+{
+	void EnqueueSwissSet(int turns, int slots)
+	{
+		ForEachSlotAllocMethod(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SetTag<swisstable::SwissSet<ElementType, typename SlotAllocType::Hash, typename SlotAllocType::Equal, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{48, "swisstable::SwissSet", EnqueueSwissSet};
+}
@@ -0,0 +1,23 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+
+namespace
+{
+	// A node per element, so it is played with the slab allocator as well.
+	//
+	void EnqueueUnorderedSet(int turns, int slots)
+	{
+		ForEachSlotAllocMethod<NodeCollectionAllocators>(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SetTag<std::unordered_set<ElementType, typename SlotAllocType::Hash, typename SlotAllocType::Equal, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{41, "std::unordered_set", EnqueueUnorderedSet};
+}
@@ -0,0 +1,36 @@
+
+#include "Pch.h"
+
+#include "Family.h"
+#include "SimdSearch.h"
+
+namespace
+{
+	// Sequence-based algorithms, unsorted and sorted.
+	// When there are many slots, these work too slowly to be included in benchmark.
+	//
+	void EnqueueVector(int turns, int slots)
+	{
+		if (slots > maxSlotsForSequence) {
+			return;
+		}
+
+		ForEachSlotAllocMethod(slots, [=] (auto slotAllocTag, auto collectionAllocatorTag)
+		{
+			using ElementType = typename decltype(slotAllocTag)::value_type::ElementType;
+			using CollectionAllocatorType = typename decltype(collectionAllocatorTag)::value_type;
+
+			Benchmark(turns, slots, SequenceUnsortedTag<std::vector<ElementType, CollectionAllocatorType>>{}, slotAllocTag);
+			Benchmark(turns, slots, SequenceSortedTag<std::vector<ElementType, CollectionAllocatorType>>{}, slotAllocTag);
+		});
+
+		ForEachPrimitiveType(slots, [=] (auto primitiveTag)
+		{
+			using PrimitiveType = typename decltype(primitiveTag)::value_type;
+
+			Benchmark(turns, slots, SequenceUnsortedSimdTag<std::vector<PrimitiveType>>{}, Tag<PrimitiveAllocMethod<PrimitiveType>>{});
+		});
+	}
+
+	const RegisterBenchmarkFamily registration{30, "std::vector", EnqueueVector};
+}
@@ -1,17 +1,33 @@
 
 #pragma once
 
+// Numbers of the slots held at every probe length (0 at their home positions) by an open-addressing collection which keeps
+// track of them (see KeepsProbeLengths). The last one counts the longer probes as well.
+//
+using ProbeLengthCounts = std::array<int64_t, 64>;
+
 struct GameResult
 {
 	int64_t SumOfSizes;
+	int64_t FinalSize; // Elements held at the end of the game,
+	int64_t FinalLiveBytes; // and the heap bytes held along with them, if counted (see MemoryProfile.h).
+	ProbeLengthCounts FinalProbeLengths; // All 0 unless counted (see ProfileProbeLengths()).
 };
 
+// Taken at the end of the game, while the collection is still alive.
+//
+inline GameResult EndOfGame(int64_t sumOfSizes, int64_t finalSize)
+{
+	return {sumOfSizes, finalSize, memoryprofile::LiveBytes()};
+}
+
 // Algorithms
 template<typename... T> struct PositionalTag : public Tag<T...> { };
 template<typename... T> struct SequenceUnsortedTag : public Tag<T...> { };
 template<typename... T> struct SequenceSortedTag : public Tag<T...> { };
 template<typename... T> struct SequenceOtherTag : public Tag<T...> { };
 template<typename... T> struct SetTag : public Tag<T...> { };
+template<typename... T> struct ConcurrentSetTag : public Tag<T...> { };
 
 template<typename T>
 struct PrimitiveAllocMethod
@@ -75,6 +91,46 @@ auto InitCollection(google::dense_hash_set<CollectionParams...>& c, AllocatorTyp
 	return Finalize([&alloc, slot0] () { alloc.Free(slot0); });
 }
 
+// The open-addressing collections which count their probe lengths by CountProbeLengths() (e.g. RobinHood.h, SwissTable.h).
+//
+template<typename Collection, typename = void>
+struct KeepsProbeLengths : std::false_type { };
+
+template<typename Collection>
+struct KeepsProbeLengths<Collection, decltype(std::declval<const Collection&>().CountProbeLengths(std::declval<ProbeLengthCounts&>()))> : std::true_type { };
+
+template<typename AlgorithmTag>
+struct AlgorithmKeepsProbeLengths : std::false_type { };
+
+template<typename SetCollection>
+struct AlgorithmKeepsProbeLengths<SetTag<SetCollection>> : KeepsProbeLengths<SetCollection> { };
+
+// Walking the whole collection would slow the game down, so the driver counts the probe lengths in a run of its own.
+// The histogram is fixed in size, so that it allocates nothing either.
+//
+inline bool& CountingProbeLengths() noexcept
+{
+	thread_local bool counting{false};
+	return counting;
+}
+
+template<typename Collection>
+void ProfileProbeLengths(const Collection&, GameResult&, std::false_type) { }
+
+template<typename Collection>
+void ProfileProbeLengths(const Collection& collection, GameResult& result, std::true_type)
+{
+	if (CountingProbeLengths()) {
+		collection.CountProbeLengths(result.FinalProbeLengths);
+	}
+}
+
+template<typename Collection>
+void ProfileProbeLengths(const Collection& collection, GameResult& result)
+{
+	ProfileProbeLengths(collection, result, KeepsProbeLengths<Collection>{});
+}
+
 template<typename RandomGenerator, typename UnknownAlgorithm, typename UnknownAllocator>
 GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerator, UnknownAlgorithm unknownAlgorithm, Tag<UnknownAllocator>) = delete;
 
@@ -89,7 +145,7 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += randomGenerator();
 	}
 
-	return {sumOfSizes};
+	return EndOfGame(sumOfSizes, 0);
 }
 
 // The collection is a fixed-sized, pre-allocated array.
@@ -121,7 +177,7 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += size;
 	}
 
-	return {sumOfSizes};
+	return EndOfGame(sumOfSizes, size);
 }
 
 template<typename RandomGenerator, typename BitMaskType>
@@ -146,7 +202,7 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += size;
 	}
 
-	return {sumOfSizes};
+	return EndOfGame(sumOfSizes, size);
 }
 
 template<typename RandomGenerator>
@@ -166,10 +222,10 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += size;
 	}
 
-	return {sumOfSizes};
+	return EndOfGame(sumOfSizes, size);
 }
 
-template<typename RandomGenerator, int Slots>
+template<typename RandomGenerator, std::size_t Slots>
 GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerator, PositionalTag<std::bitset<Slots>>, Tag<void>)
 {
 	auto collection{std::bitset<Slots>()};
@@ -186,7 +242,7 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += size;
 	}
 
-	return {sumOfSizes};
+	return EndOfGame(sumOfSizes, size);
 }
 
 template<typename RandomGenerator, typename SequenceType, typename PrimitiveType>
@@ -207,14 +263,14 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += collection.size();
 	}
 
-	return {sumOfSizes};
+	return EndOfGame(sumOfSizes, static_cast<int64_t>(collection.size()));
 }
 
 template<typename RandomGenerator, typename SequenceType, typename AllocatorType>
 GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerator, SequenceUnsortedTag<SequenceType>, Tag<AllocatorType>)
 {
-	using PrimitiveType = AllocatorType::PrimitiveType;
-	using ElementType = AllocatorType::ElementType;
+	using PrimitiveType = typename AllocatorType::PrimitiveType;
+	using ElementType = typename AllocatorType::ElementType;
 
 	auto allocator{AllocatorType{}};
 	auto collection{SequenceType{}};
@@ -233,7 +289,7 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += collection.size();
 	}
 
-	return {sumOfSizes};
+	return EndOfGame(sumOfSizes, static_cast<int64_t>(collection.size()));
 }
 
 // The collection has vector-conformant API, i.e. lower_bound(), push_back(), insert(), erase(), size().
@@ -258,14 +314,14 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += collection.size();
 	}
 
-	return {sumOfSizes};
+	return EndOfGame(sumOfSizes, static_cast<int64_t>(collection.size()));
 }
 
 template<typename RandomGenerator, typename SequenceType, typename AllocatorType>
 GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerator, SequenceSortedTag<SequenceType>, Tag<AllocatorType>)
 {
-	using ElementType = AllocatorType::ElementType;
-	using PrimitiveType = AllocatorType::PrimitiveType;
+	using ElementType = typename AllocatorType::ElementType;
+	using PrimitiveType = typename AllocatorType::PrimitiveType;
 
 	auto allocator{AllocatorType{}};
 	auto collection{SequenceType{}};
@@ -289,9 +345,10 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += collection.size();
 	}
 
-	return {sumOfSizes};
+	return EndOfGame(sumOfSizes, static_cast<int64_t>(collection.size()));
 }
 
+// Set-based algorithm: slot is an unique element in the collection.
 // The collection has set-conformant API, i.e. insert(), erase(), size().
 //
 template<typename RandomGenerator, typename SetCollection, typename PrimitiveType>
@@ -310,14 +367,16 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
 		sumOfSizes += collection.size();
 	}
 
-	return {sumOfSizes};
+	auto result = EndOfGame(sumOfSizes, static_cast<int64_t>(collection.size()));
+	ProfileProbeLengths(collection, result);
+	return result;
 }
 
 template<typename RandomGenerator, typename SetCollection, typename AllocatorType>
 GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerator, SetTag<SetCollection>, Tag<AllocatorType>)
 {
-	using PrimitiveType = AllocatorType::PrimitiveType;
-	using ElementType = AllocatorType::ElementType;
+	using PrimitiveType = typename AllocatorType::PrimitiveType;
+	using ElementType = typename AllocatorType::ElementType;
 
 	auto allocator{AllocatorType{}};
 	auto collection{SetCollection{}};
@@ -342,5 +401,26 @@ GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerat
     }
 
 	allocator.Free(slotAllocation);
-    return {sumOfSizes};
+	auto result = EndOfGame(sumOfSizes, static_cast<int64_t>(collection.size()));
+	ProfileProbeLengths(collection, result);
+	return result;
+}
+
+// The collection is safe for concurrent use, and toggles the slots itself, i.e. toggle() (returning whether the slot is present
+// afterwards), size().
+//
+template<typename RandomGenerator, typename ConcurrentSet, typename PrimitiveType>
+GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerator, ConcurrentSetTag<ConcurrentSet>, Tag<PrimitiveAllocMethod<PrimitiveType>>)
+{
+	auto collection = std::make_unique<ConcurrentSet>();
+	int64_t sumOfSizes{0};
+	int64_t size{0};
+
+	for (int turn{0}; turn < turns; ++turn)
+	{
+		size += collection->toggle(static_cast<PrimitiveType>(randomGenerator())) ? 1 : -1;
+		sumOfSizes += size;
+	}
+
+	return EndOfGame(sumOfSizes, size);
 }
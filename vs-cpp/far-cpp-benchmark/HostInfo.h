@@ -0,0 +1,166 @@
+#pragma once
+
+// Description of the host and of the build, stored along with the exported results, so that the results
+// of different machines (or of different builds of the same machine) can be told apart on the dashboards.
+//
+// Whatever cannot be determined on the platform is left out.
+
+namespace hostinfo
+{
+	using Metadata = std::vector<std::pair<std::string, std::string>>;
+
+	// Reads the first line of a (sysfs or procfs) file; empty if there is no such file.
+	//
+	inline std::string ReadLine(const std::string& path)
+	{
+		std::ifstream file{path};
+		std::string line;
+		std::getline(file, line);
+		return line;
+	}
+
+	inline std::string CpuModel()
+	{
+#if defined(__linux__)
+		std::ifstream cpuinfo{"/proc/cpuinfo"};
+		for (std::string line; std::getline(cpuinfo, line);) {
+			if (line.compare(0, 10, "model name") == 0) {
+				const auto colon = line.find(':');
+				return colon != std::string::npos && colon + 2 <= line.size() ? line.substr(colon + 2) : std::string{};
+			}
+		}
+#elif defined(_MSC_VER)
+		int registers[12]{};
+		__cpuid(registers, 0x80000000);
+		if (static_cast<unsigned>(registers[0]) >= 0x80000004) {
+			__cpuid(registers, 0x80000002);
+			__cpuid(registers + 4, 0x80000003);
+			__cpuid(registers + 8, 0x80000004);
+			const auto brand = std::string{reinterpret_cast<const char*>(registers), sizeof(registers)};
+			return brand.substr(0, brand.find('\0'));
+		}
+#endif
+		return {};
+	}
+
+	// Sizes of the caches of the first logical processor, as "L1d", "L1i", "L2", "L3" and so on.
+	//
+	inline Metadata CacheSizes()
+	{
+		Metadata caches;
+#if defined(__linux__)
+		for (int index{0};; ++index)
+		{
+			const auto directory = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + '/';
+			const auto level = ReadLine(directory + "level");
+			if (level.empty()) {
+				break;
+			}
+			const auto type = ReadLine(directory + "type");
+			const auto suffix = type == "Data" ? "d" : type == "Instruction" ? "i" : "";
+			caches.emplace_back("cache.L" + level + suffix, ReadLine(directory + "size"));
+		}
+#elif defined(_WIN32)
+		DWORD length{0};
+		GetLogicalProcessorInformation(nullptr, &length);
+		std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> information(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+		if (!information.empty() && GetLogicalProcessorInformation(information.data(), &length)) {
+			std::map<std::string, std::string> unique;
+			for (const auto& item : information) {
+				if (item.Relationship == RelationCache) {
+					const auto& cache = item.Cache;
+					const auto suffix = cache.Type == CacheData ? "d" : cache.Type == CacheInstruction ? "i" : "";
+					unique.emplace("cache.L" + std::to_string(cache.Level) + suffix, std::to_string(cache.Size / 1024) + 'K');
+				}
+			}
+			caches.assign(std::begin(unique), std::end(unique));
+		}
+#endif
+		return caches;
+	}
+
+	inline std::string CompilerVersion()
+	{
+#if defined(__clang__)
+		return "clang " __clang_version__;
+#elif defined(__GNUC__)
+		return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+		return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+		return {};
+#endif
+	}
+
+	// The flags are passed by the CMake build (CMakeLists.txt); the Visual Studio project leaves them out.
+	//
+	inline std::string CompilerFlags()
+	{
+#if defined(FAR_BUILD_FLAGS)
+		return FAR_BUILD_FLAGS;
+#else
+		return {};
+#endif
+	}
+
+	inline std::string CurrentTimeUtc()
+	{
+		const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+		std::tm utc{};
+#if defined(_WIN32)
+		gmtime_s(&utc, &now);
+#else
+		gmtime_r(&now, &utc);
+#endif
+		char text[32];
+		std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+		return text;
+	}
+
+	inline Metadata Collect()
+	{
+		Metadata metadata;
+		const auto add = [&] (const std::string& key, const std::string& value) {
+			if (!value.empty()) {
+				metadata.emplace_back(key, value);
+			}
+		};
+
+		add("time", CurrentTimeUtc());
+#if defined(__linux__)
+		utsname system;
+		if (uname(&system) == 0) {
+			add("host.name", system.nodename);
+			add("os", std::string{system.sysname} + ' ' + system.release + ' ' + system.machine);
+		}
+#elif defined(_WIN32)
+		char name[MAX_COMPUTERNAME_LENGTH + 1];
+		DWORD length{sizeof(name)};
+		if (GetComputerNameA(name, &length)) {
+			add("host.name", std::string{name, length});
+		}
+		add("os", "Windows");
+#endif
+		add("cpu.model", CpuModel());
+		add("cpu.logical_processors", std::to_string(std::thread::hardware_concurrency()));
+#if defined(__linux__)
+		const auto cpufreq = std::string{"/sys/devices/system/cpu/cpu0/cpufreq/"};
+		add("cpu.governor", ReadLine(cpufreq + "scaling_governor"));
+		add("cpu.min_khz", ReadLine(cpufreq + "scaling_min_freq"));
+		add("cpu.max_khz", ReadLine(cpufreq + "scaling_max_freq"));
+		add("cpu.boost", ReadLine("/sys/devices/system/cpu/cpufreq/boost"));
+		add("cpu.intel_no_turbo", ReadLine("/sys/devices/system/cpu/intel_pstate/no_turbo"));
+#endif
+		for (const auto& cache : CacheSizes()) {
+			add(cache.first, cache.second);
+		}
+		add("build.compiler", CompilerVersion());
+		add("build.flags", CompilerFlags());
+#if defined(NDEBUG)
+		add("build.assertions", "off");
+#else
+		add("build.assertions", "on");
+#endif
+		return metadata;
+	}
+}
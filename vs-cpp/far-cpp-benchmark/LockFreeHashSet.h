@@ -0,0 +1,363 @@
+#pragma once
+
+// Lock-free open-addressing hash set of keys up to 32 bits wide.
+//
+// Every slot of the table is a single 64-bit word, updated only by compare-and-swap:
+//   bits 0-32 hold {key}+1 (0 marks a never used slot),
+//   bit 62 (absent) marks a removed key - a tombstone,
+//   bit 63 (moved) marks a slot frozen by a migration to the next table.
+// Once claimed, a slot stays bound to its key: removing and re-adding the key only flips the absent bit. Linear probing
+// thus never needs to skip over a freed slot, and the tombstones are purged when the table is migrated.
+//
+// Migration (in the manner of C. Click's non-blocking hash table): when the table gets half full of claimed slots,
+// a next table is installed and every thread which touches the set helps to copy a chunk of slots, freezing each slot
+// before copying it. A thread which runs into a frozen slot of its key copies that slot itself, then retries in the next table.
+// The next table may need to grow before the migration into it is complete; the migrations then simply chain.
+// The retired tables are kept until the set is destroyed, in lieu of a safe memory reclamation scheme (which would cost
+// every operation a shared counter). Every migration therefore doubles the capacity, even if it is mostly to drop
+// tombstones, so the retired tables are smaller than the current one altogether. Since a table grows only when half of it
+// is claimed, and the migration keeps the present keys only, the capacity is bounded by 4 times the number of the distinct
+// keys the set has held, whatever the turnover of the keys.
+//
+// The size is kept in counters striped per thread, so that the updates of different threads do not contend.
+
+namespace lockfree
+{
+	constexpr size_t cacheLineSize{64};
+
+	// Counter split into cache-line-sized stripes; every thread updates only its own stripe (modulo {stripes}).
+	//
+	class StripedCounter
+	{
+		static constexpr size_t stripes{64};
+
+		struct alignas(cacheLineSize) Stripe
+		{
+			std::atomic<int64_t> Value{0};
+		};
+		std::unique_ptr<Stripe[]> counters{std::make_unique<Stripe[]>(stripes)};
+
+		static size_t ThisThreadStripe() noexcept
+		{
+			static std::atomic<size_t> nextStripe{0};
+			thread_local const size_t stripe{nextStripe++ % stripes};
+			return stripe;
+		}
+
+	public:
+		void Add(int64_t delta) noexcept
+		{
+			counters[ThisThreadStripe()].Value.fetch_add(delta, std::memory_order_relaxed);
+		}
+
+		int64_t Sum() const noexcept
+		{
+			int64_t sum{0};
+			for (size_t stripe{0}; stripe < stripes; ++stripe) {
+				sum += counters[stripe].Value.load(std::memory_order_relaxed);
+			}
+			return sum;
+		}
+	};
+}
+
+template<typename Key = uint32_t>
+class LockFreeHashSet
+{
+	static_assert(std::is_integral<Key>::value && sizeof(Key) <= 4, "Keys must fit into 32 bits");
+
+	using Word = uint64_t;
+
+	static constexpr Word keyMask{(Word{1} << 33) - 1};
+	static constexpr Word absentBit{Word{1} << 62};
+	static constexpr Word movedBit{Word{1} << 63};
+
+	static constexpr size_t copyChunk{1024};
+	static constexpr int probesBeforeLoadCheck{8};
+
+	struct Table
+	{
+		const size_t Capacity;
+		const int Shift;
+		std::unique_ptr<std::atomic<Word>[]> Words;
+		lockfree::StripedCounter Claimed;
+
+		std::atomic<Table*> Next{nullptr};
+		std::atomic<size_t> CopyCursor{0};
+		std::atomic<size_t> Copied{0};
+
+		explicit Table(size_t capacity) :
+			Capacity{capacity},
+			Shift{64 - Log2(capacity)},
+			Words{std::make_unique<std::atomic<Word>[]>(capacity)}
+		{
+			for (size_t index{0}; index < capacity; ++index) {
+				Words[index].store(0, std::memory_order_relaxed);
+			}
+		}
+
+		size_t Home(Word keyWord) const noexcept
+		{
+			return static_cast<size_t>((keyWord * 0x9E3779B97F4A7C15ULL) >> Shift);
+		}
+
+		static int Log2(size_t value) noexcept
+		{
+			int log{0};
+			while ((size_t{1} << log) < value) {
+				++log;
+			}
+			return log;
+		}
+	};
+
+	std::atomic<Table*> current;
+	std::vector<std::unique_ptr<Table>> tables; // All the tables ever installed, guarded by {tablesMutex}.
+	std::mutex tablesMutex;
+	lockfree::StripedCounter size_;
+
+	static Word KeyWord(Key key) noexcept { return static_cast<Word>(static_cast<std::make_unsigned_t<Key>>(key)) + 1; }
+
+	// Starts the migration of {table}, unless some other thread already did.
+	//
+	Table* Grow(Table* table)
+	{
+		if (auto next = table->Next.load()) {
+			return next;
+		}
+
+		auto next = std::make_unique<Table>(table->Capacity * 2);
+		Table* expected{nullptr};
+		if (!table->Next.compare_exchange_strong(expected, next.get())) {
+			return expected;
+		}
+
+		std::lock_guard<std::mutex> lock{tablesMutex};
+		tables.push_back(std::move(next));
+		return tables.back().get();
+	}
+
+	// Copies a frozen word into the next table, unless its key is already there. Tombstones are dropped.
+	// The next table may be migrating already (or be full, and need to), in which case the key goes further on.
+	//
+	void CopyWord(Table* next, Word frozen)
+	{
+		const auto keyWord = frozen & keyMask;
+		if (keyWord == 0 || (frozen & absentBit) != 0) {
+			return;
+		}
+
+		auto index = next->Home(keyWord);
+		for (size_t probes{0}; probes < next->Capacity; ++probes, index = (index + 1) & (next->Capacity - 1))
+		{
+			auto word = next->Words[index].load();
+			if (word == 0 && next->Words[index].compare_exchange_strong(word, keyWord)) {
+				next->Claimed.Add(1);
+				return;
+			}
+			if ((word & keyMask) == keyWord) {
+				return;
+			}
+			if (word == movedBit) {
+				CopyWord(next->Next.load(), frozen);
+				return;
+			}
+		}
+		CopyWord(Grow(next), frozen);
+	}
+
+	// Copies a chunk of {table}, freezing every slot first. Once all the chunks are done, the current table moves on.
+	//
+	void HelpMigrate(Table* table)
+	{
+		const auto next = table->Next.load();
+		if (next == nullptr) {
+			return;
+		}
+
+		const auto begin = table->CopyCursor.fetch_add(copyChunk);
+		if (begin >= table->Capacity) {
+			return;
+		}
+
+		const auto end = std::min(begin + copyChunk, table->Capacity);
+		for (auto index = begin; index < end; ++index)
+		{
+			auto word = table->Words[index].load();
+			while ((word & movedBit) == 0) {
+				if (table->Words[index].compare_exchange_weak(word, word | movedBit)) {
+					CopyWord(next, word);
+					break;
+				}
+			}
+		}
+
+		if (table->Copied.fetch_add(end - begin) + (end - begin) == table->Capacity)
+		{
+			// The successors may have completed their migrations before this one did.
+			//
+			for (auto migrated = current.load(); migrated->Next.load() != nullptr && migrated->Copied.load() == migrated->Capacity;) {
+				current.compare_exchange_strong(migrated, migrated->Next.load());
+				migrated = current.load();
+			}
+		}
+	}
+
+	// A frozen slot of the key: make sure the key is in the next table (it may be still on its way), and continue there.
+	//
+	Table* FollowMoved(Table* table, Word frozen)
+	{
+		const auto next = table->Next.load();
+		CopyWord(next, frozen);
+		return next;
+	}
+
+	struct Location
+	{
+		Table* Owner; // The table the slot is in.
+		size_t Index; // The capacity of {Owner} if the key is not there.
+		bool Claimed; // True if the slot was empty, and has just been claimed for the key (as present).
+	};
+
+	// Finds the slot of the key, starting at {table} and following the migrations. If {claim}, an empty slot is claimed
+	// when the key is not found.
+	//
+	Location Locate(Table* table, Word keyWord, bool claim)
+	{
+		for (;;)
+		{
+			HelpMigrate(table);
+
+			int probes{0};
+			for (auto index = table->Home(keyWord);; index = (index + 1) & (table->Capacity - 1), ++probes)
+			{
+				// The key is not in the table, and there is no room left: continue in the next one.
+				//
+				if (probes == static_cast<int>(table->Capacity)) {
+					if (table->Next.load() == nullptr && !claim) {
+						return {table, table->Capacity, false};
+					}
+					table = Grow(table);
+					break;
+				}
+
+				// Grow when half of the slots are claimed, but only check that once the probe gets long.
+				// The key may still be in this table, so look again here; the frozen slots lead to the next one.
+				//
+				if (claim && probes == probesBeforeLoadCheck && table->Next.load() == nullptr &&
+					static_cast<size_t>(table->Claimed.Sum()) * 2 >= table->Capacity)
+				{
+					Grow(table);
+					break;
+				}
+
+				auto word = table->Words[index].load();
+				if (word == 0) {
+					if (!claim) {
+						return {table, table->Capacity, false};
+					}
+					if (table->Words[index].compare_exchange_strong(word, keyWord)) {
+						table->Claimed.Add(1);
+						return {table, index, true};
+					}
+				}
+				if (word == movedBit) {
+					// A frozen empty slot: the key is not in this table, but may already be in the next one.
+					//
+					table = table->Next.load();
+					break;
+				}
+				if ((word & keyMask) == keyWord) {
+					if ((word & movedBit) != 0) {
+						table = FollowMoved(table, word);
+						break;
+					}
+					return {table, index, false};
+				}
+			}
+		}
+	}
+
+	enum class Operation { Insert, Erase, Toggle };
+
+	// Returns whether the key was present before the operation.
+	//
+	bool Update(Key key, Operation operation)
+	{
+		const auto keyWord = KeyWord(key);
+		auto table = current.load();
+
+		for (;;)
+		{
+			const auto location = Locate(table, keyWord, operation != Operation::Erase);
+			if (location.Claimed) {
+				size_.Add(1);
+				return false;
+			}
+			table = location.Owner;
+			if (location.Index == table->Capacity) {
+				return false;
+			}
+
+			auto& slot = table->Words[location.Index];
+			auto word = slot.load();
+			for (;;)
+			{
+				if ((word & movedBit) != 0) {
+					table = FollowMoved(table, word);
+					break;
+				}
+
+				const auto wasPresent = (word & absentBit) == 0;
+				const auto nowPresent = operation == Operation::Toggle ? !wasPresent : operation == Operation::Insert;
+				if (wasPresent == nowPresent) {
+					return wasPresent;
+				}
+				if (slot.compare_exchange_weak(word, nowPresent ? keyWord : keyWord | absentBit)) {
+					size_.Add(nowPresent ? 1 : -1);
+					return wasPresent;
+				}
+			}
+		}
+	}
+
+public:
+	using value_type = Key;
+
+	explicit LockFreeHashSet(size_t initialCapacity = 64)
+	{
+		size_t capacity{16};
+		while (capacity < initialCapacity) {
+			capacity *= 2;
+		}
+		tables.push_back(std::make_unique<Table>(capacity));
+		current.store(tables.back().get());
+	}
+
+	LockFreeHashSet(const LockFreeHashSet&) = delete;
+	LockFreeHashSet& operator=(const LockFreeHashSet&) = delete;
+
+	bool contains(Key key)
+	{
+		const auto location = Locate(current.load(), KeyWord(key), false);
+		if (location.Index == location.Owner->Capacity) {
+			return false;
+		}
+		const auto word = location.Owner->Words[location.Index].load();
+		if ((word & movedBit) != 0) {
+			return contains(key); // Frozen meanwhile; look again, in the next table.
+		}
+		return (word & absentBit) == 0;
+	}
+
+	// Each returns true if the set has changed.
+	//
+	bool insert(Key key) { return !Update(key, Operation::Insert); }
+	bool erase(Key key) { return Update(key, Operation::Erase); }
+
+	// Adds the key if absent, removes it otherwise. Returns true if the key is present afterwards.
+	//
+	bool toggle(Key key) { return !Update(key, Operation::Toggle); }
+
+	int64_t size() const noexcept { return size_.Sum(); }
+};
@@ -0,0 +1,153 @@
+#include "Pch.h"
+
+#include "Common.h"
+#include "MemoryProfile.h"
+
+// The replaceable global allocation functions, counting into the statistics of the calling thread (if any).
+// Everything else is left to malloc, as with the operators of the standard library.
+
+namespace memoryprofile
+{
+	thread_local AllocationStats* threadStats{nullptr};
+}
+
+namespace
+{
+	size_t UsableSize(void* block) noexcept
+	{
+#if defined(_WIN32)
+		return _msize(block);
+#else
+		return malloc_usable_size(block);
+#endif
+	}
+
+	// The usable size of a block costs a lookup in the heap, so it is only taken while counting, not in the timed runs.
+	//
+	bool Counting() noexcept
+	{
+		return memoryprofile::threadStats != nullptr;
+	}
+
+	void* Allocate(size_t size) noexcept
+	{
+		const auto block = std::malloc(size != 0 ? size : 1);
+		if (block != nullptr && Counting()) {
+			memoryprofile::CountAllocated(UsableSize(block));
+		}
+		return block;
+	}
+
+	void Free(void* block) noexcept
+	{
+		if (block != nullptr) {
+			if (Counting()) {
+				memoryprofile::CountFreed(UsableSize(block));
+			}
+			std::free(block);
+		}
+	}
+
+#if defined(__cpp_aligned_new)
+	void* AllocateAligned(size_t size, std::align_val_t alignment) noexcept
+	{
+		const auto bytes = std::max<size_t>(size, 1);
+		const auto align = static_cast<size_t>(alignment);
+#if defined(_WIN32)
+		const auto block = _aligned_malloc(bytes, align);
+		if (block != nullptr && Counting()) {
+			memoryprofile::CountAllocated(_aligned_msize(block, align, 0));
+		}
+		return block;
+#else
+		void* block{nullptr};
+		if (posix_memalign(&block, std::max(align, sizeof(void*)), bytes) != 0) {
+			return nullptr;
+		}
+		if (Counting()) {
+			memoryprofile::CountAllocated(UsableSize(block));
+		}
+		return block;
+#endif
+	}
+
+	void FreeAligned(void* block, std::align_val_t alignment) noexcept
+	{
+		if (block != nullptr) {
+#if defined(_WIN32)
+			if (Counting()) {
+				memoryprofile::CountFreed(_aligned_msize(block, static_cast<size_t>(alignment), 0));
+			}
+			_aligned_free(block);
+#else
+			if (Counting()) {
+				memoryprofile::CountFreed(UsableSize(block));
+			}
+			std::free(block);
+#endif
+		}
+	}
+#endif
+}
+
+void* operator new(size_t size)
+{
+	if (const auto block = Allocate(size)) {
+		return block;
+	}
+	throw std::bad_alloc{};
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void operator delete(void* block) noexcept { Free(block); }
+void operator delete[](void* block) noexcept { Free(block); }
+void operator delete(void* block, size_t) noexcept { Free(block); }
+void operator delete[](void* block, size_t) noexcept { Free(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { Free(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { Free(block); }
+
+#if defined(__cpp_aligned_new)
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	if (const auto block = AllocateAligned(size, alignment)) {
+		return block;
+	}
+	throw std::bad_alloc{};
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* block, std::align_val_t alignment) noexcept { FreeAligned(block, alignment); }
+void operator delete[](void* block, std::align_val_t alignment) noexcept { FreeAligned(block, alignment); }
+void operator delete(void* block, size_t, std::align_val_t alignment) noexcept { FreeAligned(block, alignment); }
+void operator delete[](void* block, size_t, std::align_val_t alignment) noexcept { FreeAligned(block, alignment); }
+void operator delete(void* block, std::align_val_t alignment, const std::nothrow_t&) noexcept { FreeAligned(block, alignment); }
+void operator delete[](void* block, std::align_val_t alignment, const std::nothrow_t&) noexcept { FreeAligned(block, alignment); }
+#endif
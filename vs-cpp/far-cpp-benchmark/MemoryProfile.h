@@ -0,0 +1,125 @@
+#pragma once
+
+// Memory footprint of the games: the heap allocations counted by the replaced global operators new and delete
+// (MemoryProfile.cpp), and the resident set size of the process.
+//
+// The allocations are counted per thread, and only while a CountAllocations object is alive on it, so the cells measured
+// concurrently do not mix. The sizes are the usable sizes of the blocks, i.e. including the rounding of the allocator.
+// The resident set size belongs to the whole process: it only describes a cell if the cells are played one by one.
+
+namespace memoryprofile
+{
+	struct AllocationStats
+	{
+		int64_t Allocations{0};
+		int64_t BytesAllocated{0};
+		int64_t LiveBytes{0}; // Allocated and not yet freed; negative if more was freed than allocated while counted.
+		int64_t PeakLiveBytes{0};
+	};
+
+	// The statistics of the allocations of the calling thread, if they are being counted. Defined in MemoryProfile.cpp.
+	//
+	extern thread_local AllocationStats* threadStats;
+
+	inline int64_t LiveBytes() noexcept
+	{
+		return threadStats != nullptr ? threadStats->LiveBytes : 0;
+	}
+
+	// Counts a block allocated (or freed) by the calling thread. Also used by the allocators which serve the blocks
+	// out of memory of their own (e.g. SlabAllocator.h), so that the blocks are counted rather than their chunks.
+	//
+	inline void CountAllocated(size_t usableSize) noexcept
+	{
+		if (const auto stats = threadStats) {
+			const auto bytes = static_cast<int64_t>(usableSize);
+			++stats->Allocations;
+			stats->BytesAllocated += bytes;
+			stats->LiveBytes += bytes;
+			stats->PeakLiveBytes = std::max(stats->PeakLiveBytes, stats->LiveBytes);
+		}
+	}
+
+	inline void CountFreed(size_t usableSize) noexcept
+	{
+		if (const auto stats = threadStats) {
+			stats->LiveBytes -= static_cast<int64_t>(usableSize);
+		}
+	}
+
+	// Counts the allocations of the calling thread into {stats} (if not null) for the lifetime of the object.
+	//
+	class CountAllocations
+	{
+		AllocationStats* const previous;
+
+	public:
+		explicit CountAllocations(AllocationStats* stats) noexcept :
+			previous{threadStats}
+		{
+			threadStats = stats;
+		}
+
+		~CountAllocations()
+		{
+			threadStats = previous;
+		}
+
+		CountAllocations(const CountAllocations&) = delete;
+		CountAllocations& operator=(const CountAllocations&) = delete;
+	};
+
+	// Reads a "Vm*: N kB" line of /proc/self/status, in bytes; -1 if unknown.
+	//
+	inline int64_t ReadProcessStatus(const std::string& key)
+	{
+#if defined(__linux__)
+		std::ifstream status{"/proc/self/status"};
+		for (std::string line; std::getline(status, line);) {
+			if (line.compare(0, key.size(), key) == 0 && line.size() > key.size() && line[key.size()] == ':') {
+				return std::stoll(line.substr(key.size() + 1)) * 1024;
+			}
+		}
+#endif
+		return -1;
+	}
+
+	inline int64_t ResidentBytes()
+	{
+		return ReadProcessStatus("VmRSS");
+	}
+
+	inline int64_t PeakResidentBytes()
+	{
+		return ReadProcessStatus("VmHWM");
+	}
+
+	// Returns the free memory of the heap to the system and restarts the peak of the resident set size from the current one,
+	// so that the growth of the peak can be attributed to what runs next. False if the peak cannot be reset.
+	//
+	inline bool ResetPeakResidentBytes()
+	{
+#if defined(__linux__)
+#if defined(__GLIBC__)
+		malloc_trim(0);
+#endif
+		std::ofstream clearRefs{"/proc/self/clear_refs"};
+		clearRefs << "5";
+		clearRefs.close();
+		return static_cast<bool>(clearRefs);
+#else
+		return false;
+#endif
+	}
+
+	// Memory profile of a cell, taken in a run of its own.
+	//
+	struct CellMemory
+	{
+		int64_t Allocations{-1}; // -1 unless profiled (see BenchmarkOptions::ProfileMemory).
+		int64_t BytesAllocated{-1};
+		int64_t PeakLiveBytes{-1};
+		double BytesPerElement{std::numeric_limits<double>::quiet_NaN()}; // Heap bytes held at the end of the game, per element held.
+		int64_t PeakResidentGrowthBytes{-1}; // -1 if unknown.
+	};
+}
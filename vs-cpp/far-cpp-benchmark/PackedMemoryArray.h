@@ -0,0 +1,209 @@
+#pragma once
+
+// Packed memory array: a sorted array of slots with gaps, so that a slot is added or removed by moving only its neighbours.
+//
+// The array is cut into segments of a power of 2 slots, about the logarithm of the capacity, holding their slots packed
+// at the start. The segments are the leaves of an implicit binary tree of windows, whose densities must stay between
+// bounds getting tighter from the leaves to the root. A segment going over (or under) its bounds has the slots of the
+// smallest enclosing window within its own bounds spread evenly over it, and if there is no such window, the capacity
+// is doubled (or halved). That takes O(log^2 n) moves amortized, while the slots stay sorted and nearly contiguous.
+// The lower bounds keep every segment non-empty (unless there is just one), so the segment of a slot is found by
+// binary search of the first slots of the segments. The collection has the set-conformant API of SetTag (FindAddRemove.h).
+
+namespace packedmemoryarray
+{
+	template<typename T>
+	class PackedMemoryArray
+	{
+		static constexpr size_t minSegmentSize{8};
+
+		// Density bounds of the leaves and of the root; those of the windows in between are interpolated.
+		//
+		static constexpr double leafLower{0.125};
+		static constexpr double rootLower{0.3};
+		static constexpr double rootUpper{0.75};
+		static constexpr double leafUpper{1.0};
+
+		std::vector<T> keys;
+		std::vector<uint32_t> counts; // Per segment.
+		std::vector<T> spread; // The slots of the window being rebalanced.
+		size_t segmentSize{minSegmentSize};
+		int height{0}; // Of the tree of windows: the root spans 2^height segments.
+		size_t count{0};
+
+		size_t Segments() const noexcept
+		{
+			return counts.size();
+		}
+
+		// The bounds of the number of slots of a window of 2^{level} segments.
+		//
+		double Lower(int level) const noexcept
+		{
+			const auto depth = height != 0 ? static_cast<double>(level) / height : 1.0;
+			return (leafLower + (rootLower - leafLower) * depth) * static_cast<double>(segmentSize << level);
+		}
+
+		double Upper(int level) const noexcept
+		{
+			const auto depth = height != 0 ? static_cast<double>(level) / height : 1.0;
+			return (leafUpper - (leafUpper - rootUpper) * depth) * static_cast<double>(segmentSize << level);
+		}
+
+		// The slots of the segments [{first}, {first} + {segments}) into {spread}, in order, along with {added} (if any).
+		//
+		void Gather(size_t first, size_t segments, const T* added)
+		{
+			spread.clear();
+			for (size_t s{first}; s < first + segments; ++s) {
+				const auto begin = std::begin(keys) + static_cast<ptrdiff_t>(s * segmentSize);
+				spread.insert(std::end(spread), begin, begin + counts[s]);
+			}
+			if (added != nullptr) {
+				spread.insert(std::lower_bound(std::begin(spread), std::end(spread), *added), *added);
+			}
+		}
+
+		// Lays out {spread} evenly over the segments [{first}, {first} + {segments}).
+		//
+		void Spread(size_t first, size_t segments)
+		{
+			const auto total = spread.size();
+			auto from = std::begin(spread);
+			for (size_t s{0}; s < segments; ++s)
+			{
+				const auto n = total / segments + (s < total % segments ? 1 : 0);
+				std::copy(from, from + static_cast<ptrdiff_t>(n), std::begin(keys) + static_cast<ptrdiff_t>((first + s) * segmentSize));
+				counts[first + s] = static_cast<uint32_t>(n);
+				from += static_cast<ptrdiff_t>(n);
+			}
+		}
+
+		// Lays out {spread} (all the slots) in the least capacity which keeps the root within its upper bound.
+		//
+		void Resize()
+		{
+			size_t capacity{minSegmentSize};
+			while (static_cast<double>(spread.size()) > rootUpper * static_cast<double>(capacity)) {
+				capacity *= 2;
+			}
+
+			size_t log2Capacity{0};
+			while ((size_t{1} << log2Capacity) < capacity) {
+				++log2Capacity;
+			}
+			segmentSize = minSegmentSize;
+			while (segmentSize < log2Capacity) {
+				segmentSize *= 2;
+			}
+			height = 0;
+			while ((segmentSize << height) < capacity) {
+				++height;
+			}
+
+			keys.assign(capacity, T{});
+			counts.assign(capacity / segmentSize, 0);
+			Spread(0, Segments());
+		}
+
+		// Brings the segment {segment}, out of its bounds with {added} (if any), back within them.
+		//
+		void Rebalance(size_t segment, const T* added)
+		{
+			const auto change = added != nullptr ? 1.0 : 0.0;
+			for (int level{1}; level <= height; ++level)
+			{
+				const auto first = (segment >> level) << level;
+				const auto segments = size_t{1} << level;
+				double n{change};
+				for (size_t s{first}; s < first + segments; ++s) {
+					n += counts[s];
+				}
+				if (n >= Lower(level) && n <= Upper(level)) {
+					Gather(first, segments, added);
+					Spread(first, segments);
+					return;
+				}
+			}
+
+			Gather(0, Segments(), added);
+			Resize();
+		}
+
+		// The segment which holds {key} if present, i.e. the last one starting not after it (or the first one).
+		//
+		size_t FindSegment(T key) const
+		{
+			size_t lo{0};
+			size_t hi{Segments()};
+			while (hi - lo > 1)
+			{
+				const auto mid = lo + (hi - lo) / 2;
+				if (key < keys[mid * segmentSize]) {
+					hi = mid;
+				} else {
+					lo = mid;
+				}
+			}
+			return lo;
+		}
+
+	public:
+		struct Position
+		{
+			size_t Segment;
+			size_t Index; // Within the segment.
+		};
+
+		PackedMemoryArray() :
+			keys(minSegmentSize),
+			counts(1, 0)
+		{ }
+
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		// Adds {key} unless present; returns where it is and whether it was added.
+		//
+		std::pair<Position, bool> insert(T key)
+		{
+			auto segment = FindSegment(key);
+			auto begin = std::begin(keys) + static_cast<ptrdiff_t>(segment * segmentSize);
+			auto end = begin + counts[segment];
+			auto at = std::lower_bound(begin, end, key);
+			if (at != end && *at == key) {
+				return {{segment, static_cast<size_t>(at - begin)}, false};
+			}
+
+			++count;
+			if (counts[segment] + 1 <= Upper(0)) {
+				std::move_backward(at, end, end + 1);
+				*at = key;
+				++counts[segment];
+				return {{segment, static_cast<size_t>(at - begin)}, true};
+			}
+
+			Rebalance(segment, &key);
+			segment = FindSegment(key);
+			begin = std::begin(keys) + static_cast<ptrdiff_t>(segment * segmentSize);
+			at = std::lower_bound(begin, begin + counts[segment], key);
+			return {{segment, static_cast<size_t>(at - begin)}, true};
+		}
+
+		void erase(Position position)
+		{
+			const auto begin = std::begin(keys) + static_cast<ptrdiff_t>(position.Segment * segmentSize);
+			std::move(begin + static_cast<ptrdiff_t>(position.Index + 1), begin + counts[position.Segment], begin + static_cast<ptrdiff_t>(position.Index));
+			--counts[position.Segment];
+			--count;
+
+			// A single segment may even get empty.
+			//
+			if (height != 0 && counts[position.Segment] < Lower(0)) {
+				Rebalance(position.Segment, nullptr);
+			}
+		}
+	};
+}
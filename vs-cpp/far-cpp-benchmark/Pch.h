@@ -1,12 +1,15 @@
 
 #pragma once
 
+#if defined(_MSC_VER)
 #include <SDKDDKVer.h>
 
 #pragma warning ( disable : 4996 )
+#endif
 
 // Standard Library
 #include <set>
+#include <list>
 #include <map>
 #include <deque>
 #include <bitset>
@@ -17,7 +20,61 @@
 #include <iostream>
 #include <algorithm>
 #include <sstream>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <exception>
 #include <unordered_set>
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <array>
+#include <regex>
+#include <typeinfo>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <ctime>
+#include <type_traits>
+#if defined(FAR_PMR_ALLOCATORS)
+#include <memory_resource>
+#endif
+
+// Platform
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+#if defined(__linux__)
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <malloc.h>
+#endif
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <malloc.h>
+#endif
 
 // Boost
 #include <boost/container/flat_set.hpp>
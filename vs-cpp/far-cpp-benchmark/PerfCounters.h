@@ -0,0 +1,198 @@
+#pragma once
+
+// Hardware performance counters of the calling thread, read around the measured runs (Linux perf_event_open).
+//
+// The events are opened as a single group, so that all of them count over exactly the same interval. The events the CPU
+// does not provide (or the hypervisor does not pass through), and those beyond what the PMU can schedule at once,
+// are left out of the group and reported as NaN. Containers often forbid perf_event_open altogether (seccomp,
+// perf_event_paranoid); then nothing is counted and the benchmark runs as usual. Only the user space is counted.
+
+namespace perfcounters
+{
+	constexpr int events{8};
+	constexpr const char* eventNames[events]{
+		"cycles",
+		"instructions",
+		"l1d_misses",
+		"llc_misses",
+		"dtlb_misses",
+		"branch_misses",
+		"stalled_cycles_frontend",
+		"stalled_cycles_backend"
+	};
+
+	using Counts = std::array<double, events>;
+
+	inline Counts NotCounted()
+	{
+		Counts counts;
+		counts.fill(std::numeric_limits<double>::quiet_NaN());
+		return counts;
+	}
+
+	class CounterGroup
+	{
+#if defined(__linux__)
+		std::vector<int> eventFds; // In the order of the group, the leader first.
+		std::vector<int> eventIndices; // Into {eventNames}, for each of {eventFds}.
+
+		struct EventConfig
+		{
+			uint32_t Type;
+			uint64_t Config;
+		};
+
+		static EventConfig Config(int event)
+		{
+			const auto cache = [] (uint64_t cache, uint64_t operation, uint64_t result) {
+				return EventConfig{PERF_TYPE_HW_CACHE, cache | (operation << 8) | (result << 16)};
+			};
+			switch (event) {
+				case 0: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+				case 1: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+				case 2: return cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS);
+				case 3: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+				case 4: return cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS);
+				case 5: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+				case 6: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND};
+				default: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND};
+			}
+		}
+
+		static int OpenEvent(int event, int groupFd)
+		{
+			const auto config = Config(event);
+			perf_event_attr attr{};
+			attr.size = sizeof(attr);
+			attr.type = config.Type;
+			attr.config = config.Config;
+			attr.disabled = groupFd == -1 ? 1 : 0; // The group follows its leader.
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+		}
+
+		void Close()
+		{
+			for (const auto fd : eventFds) {
+				close(fd);
+			}
+			eventFds.clear();
+			eventIndices.clear();
+		}
+
+		// Opens up to {maxEvents} of the events that can be opened at all.
+		//
+		void Open(int maxEvents)
+		{
+			for (int event{0}; event < events && static_cast<int>(eventFds.size()) < maxEvents; ++event)
+			{
+				const auto fd = OpenEvent(event, eventFds.empty() ? -1 : eventFds.front());
+				if (fd != -1) {
+					eventFds.push_back(fd);
+					eventIndices.push_back(event);
+				}
+			}
+		}
+
+		// Reads the group as {count, time enabled, time running, values...}; false if it was never scheduled.
+		//
+		bool Read(std::vector<uint64_t>& buffer) const
+		{
+			buffer.assign(3 + eventFds.size(), 0);
+			const auto size = static_cast<ssize_t>(buffer.size() * sizeof(uint64_t));
+			return read(eventFds.front(), buffer.data(), static_cast<size_t>(size)) == size && buffer[2] != 0;
+		}
+
+		std::vector<uint64_t> readBuffer;
+
+	public:
+		CounterGroup()
+		{
+			// A group the PMU cannot fit never runs: shrink it until it does.
+			//
+			for (auto maxEvents = events; maxEvents > 0; --maxEvents)
+			{
+				Open(maxEvents);
+				if (eventFds.empty()) {
+					return;
+				}
+
+				Start();
+				volatile uint64_t work{0};
+				for (int i{0}; i < 100000; ++i) {
+					work += i;
+				}
+				ioctl(eventFds.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+				if (Read(readBuffer)) {
+					return;
+				}
+
+				maxEvents = std::min(maxEvents, static_cast<int>(eventFds.size()));
+				Close();
+			}
+		}
+
+		~CounterGroup()
+		{
+			Close();
+		}
+
+		bool Available() const noexcept
+		{
+			return !eventFds.empty();
+		}
+
+		bool IsCounting(int event) const
+		{
+			return std::find(std::begin(eventIndices), std::end(eventIndices), event) != std::end(eventIndices);
+		}
+
+		void Start()
+		{
+			if (Available()) {
+				ioctl(eventFds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+				ioctl(eventFds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+			}
+		}
+
+		// Counts of the events since Start, extrapolated if the group was time-shared with other groups.
+		//
+		perfcounters::Counts Stop()
+		{
+			auto counts = NotCounted();
+			if (!Available()) {
+				return counts;
+			}
+
+			ioctl(eventFds.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+			if (Read(readBuffer)) {
+				const auto scale = static_cast<double>(readBuffer[1]) / static_cast<double>(readBuffer[2]);
+				for (size_t i{0}; i < eventIndices.size(); ++i) {
+					counts[eventIndices[i]] = static_cast<double>(readBuffer[3 + i]) * scale;
+				}
+			}
+			return counts;
+		}
+#else
+	public:
+		CounterGroup() = default;
+		bool Available() const noexcept { return false; }
+		bool IsCounting(int) const { return false; }
+		void Start() { }
+		perfcounters::Counts Stop() { return NotCounted(); }
+#endif
+
+		CounterGroup(const CounterGroup&) = delete;
+		CounterGroup& operator=(const CounterGroup&) = delete;
+	};
+
+	// The group of the calling thread, opened on the first use: the counters only count the thread which opened them.
+	//
+	inline CounterGroup& ThreadCounterGroup()
+	{
+		thread_local CounterGroup group;
+		return group;
+	}
+}
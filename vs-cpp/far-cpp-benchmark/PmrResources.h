@@ -0,0 +1,251 @@
+#pragma once
+
+// Polymorphic memory resources (std::pmr) of the allocator axes, built with FAR_PMR_ALLOCATORS (see CMakeLists.txt).
+//
+// Every resource is backed by a buffer reserved up front, and by the heap beyond it: directly the monotonic_buffer_resource,
+// and the pool resources through a monotonic_buffer_resource as their upstream. The collections share the resource (and
+// the buffer) of the thread (PmrAllocator), while the slots get one for the game of their own, over a buffer of its own
+// (slotallocmethod::PmrAllocMethod). A resource is released as soon as all of its blocks are freed, so the memory never
+// reused by a monotonic resource is reclaimed by the end of every game. The memory profile counts the blocks handed out.
+
+#if defined(FAR_PMR_ALLOCATORS)
+
+namespace pmrresource
+{
+	constexpr size_t bufferBytes{64 * 1024 * 1024}; // Only the pages touched become resident.
+
+	// The buffer of the resources of the kind {Resource} shared by the collections of the calling thread.
+	//
+	template<typename Resource>
+	char* ThreadBuffer()
+	{
+		struct Buffer
+		{
+			char* const Bytes{static_cast<char*>(std::malloc(bufferBytes))};
+
+			~Buffer()
+			{
+				std::free(Bytes);
+			}
+		};
+
+		thread_local Buffer buffer;
+		if (buffer.Bytes == nullptr) {
+			throw std::bad_alloc{};
+		}
+		return buffer.Bytes;
+	}
+
+	// A buffer of its own for every owner (slotallocmethod::PmrAllocMethod), so that no two live owners share one. The buffers
+	// are handed back to the calling thread rather than freed, so that the pages touched by a game are warm in the next one.
+	// The spare buffers are linked through their first bytes.
+	//
+	class LentBuffer
+	{
+		struct Spares
+		{
+			char* First{nullptr};
+
+			~Spares()
+			{
+				while (First != nullptr) {
+					std::free(std::exchange(First, *reinterpret_cast<char**>(First)));
+				}
+			}
+		};
+
+		static Spares& ThreadSpares() noexcept
+		{
+			thread_local Spares spares;
+			return spares;
+		}
+
+		char* const bytes;
+
+		static char* Borrow()
+		{
+			auto& spares = ThreadSpares();
+			if (spares.First != nullptr) {
+				return std::exchange(spares.First, *reinterpret_cast<char**>(spares.First));
+			}
+
+			memoryprofile::CountAllocations uncounted{nullptr}; // Only the blocks carved from the buffer are counted.
+			const auto bytes = static_cast<char*>(std::malloc(bufferBytes));
+			if (bytes == nullptr) {
+				throw std::bad_alloc{};
+			}
+			return bytes;
+		}
+
+	public:
+		LentBuffer() :
+			bytes{Borrow()}
+		{ }
+
+		~LentBuffer()
+		{
+			auto& spares = ThreadSpares();
+			*reinterpret_cast<char**>(bytes) = spares.First;
+			spares.First = bytes;
+		}
+
+		LentBuffer(const LentBuffer&) = delete;
+		LentBuffer& operator=(const LentBuffer&) = delete;
+
+		char* Bytes() const noexcept
+		{
+			return bytes;
+		}
+	};
+
+	// The resource of the kind {Resource} over the buffer, in a pool over a monotonic upstream.
+	//
+	template<typename Resource>
+	class ResourceStack
+	{
+		std::pmr::monotonic_buffer_resource upstream;
+		Resource pool;
+
+	public:
+		explicit ResourceStack(char* buffer) :
+			upstream{buffer, bufferBytes},
+			pool{&upstream}
+		{ }
+
+		std::pmr::memory_resource& Get() noexcept
+		{
+			return pool;
+		}
+
+		void Release()
+		{
+			pool.release();
+			upstream.release();
+		}
+	};
+
+	template<>
+	class ResourceStack<std::pmr::monotonic_buffer_resource>
+	{
+		std::pmr::monotonic_buffer_resource monotonic;
+
+	public:
+		explicit ResourceStack(char* buffer) :
+			monotonic{buffer, bufferBytes}
+		{ }
+
+		std::pmr::memory_resource& Get() noexcept
+		{
+			return monotonic;
+		}
+
+		void Release()
+		{
+			monotonic.release();
+		}
+	};
+
+	template<typename Resource>
+	class BufferedResource final : public std::pmr::memory_resource
+	{
+		ResourceStack<Resource> stack;
+		int64_t liveBlocks{0};
+
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			void* block;
+			{
+				memoryprofile::CountAllocations uncounted{nullptr}; // The chunks taken from the heap are not the blocks.
+				block = stack.Get().allocate(bytes, alignment);
+			}
+			++liveBlocks;
+			memoryprofile::CountAllocated(bytes);
+			return block;
+		}
+
+		void do_deallocate(void* block, size_t bytes, size_t alignment) override
+		{
+			{
+				memoryprofile::CountAllocations uncounted{nullptr};
+				stack.Get().deallocate(block, bytes, alignment);
+				if (--liveBlocks == 0) {
+					stack.Release();
+				}
+			}
+			memoryprofile::CountFreed(bytes);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+
+	public:
+		explicit BufferedResource(char* buffer) :
+			stack{buffer}
+		{ }
+
+		BufferedResource(const BufferedResource&) = delete;
+		BufferedResource& operator=(const BufferedResource&) = delete;
+	};
+
+	template<typename Resource>
+	BufferedResource<Resource>& ThreadResource()
+	{
+		thread_local BufferedResource<Resource> resource{ThreadBuffer<Resource>()};
+		return resource;
+	}
+
+	// The polymorphic allocator bound to the resource of the kind {Resource} of the thread, so that the collections can be
+	// default-constructed; the legacy members are there for the vendored containers.
+	//
+	template<typename T, typename Resource>
+	class PmrAllocator : public std::pmr::polymorphic_allocator<T>
+	{
+		using BaseClass = std::pmr::polymorphic_allocator<T>;
+
+	public:
+		using pointer = T*;
+		using const_pointer = const T*;
+		using reference = T&;
+		using const_reference = const T&;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+
+		template<typename U>
+		struct rebind
+		{
+			using other = PmrAllocator<U, Resource>;
+		};
+
+		PmrAllocator() noexcept :
+			BaseClass{&ThreadResource<Resource>()}
+		{ }
+
+		PmrAllocator(const PmrAllocator& other) noexcept :
+			BaseClass{other.resource()}
+		{ }
+
+		template<typename U>
+		PmrAllocator(const PmrAllocator<U, Resource>& other) noexcept :
+			BaseClass{other.resource()}
+		{ }
+
+		PmrAllocator& operator=(const PmrAllocator&) noexcept
+		{
+			return *this; // All of the kind share the resource of the thread.
+		}
+
+		PmrAllocator select_on_container_copy_construction() const noexcept
+		{
+			return *this;
+		}
+
+		size_type max_size() const noexcept
+		{
+			return std::numeric_limits<size_type>::max() / sizeof(T);
+		}
+	};
+}
+
+#endif
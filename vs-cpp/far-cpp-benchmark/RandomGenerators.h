@@ -0,0 +1,269 @@
+#pragma once
+
+// Pseudo-random generator policies, usable as the RandomGenerator argument of PlayFindAddRemove().
+//
+// A generator is constructed with the number of slots and its call operator yields a slot within the range
+// from 1 to {slots}-1 (slot 0 is reserved as the empty/deleted key of some hash sets).
+
+namespace randomengine
+{
+	constexpr uint64_t defaultSeed{0x853C49E6748FEA9BULL};
+
+	inline uint64_t RotateLeft(uint64_t x, int k) noexcept
+	{
+		return (x << k) | (x >> (64 - k));
+	}
+
+	// High 64 bits of the 128-bit product.
+	//
+	inline uint64_t MultiplyHigh(uint64_t a, uint64_t b) noexcept
+	{
+#if defined(__SIZEOF_INT128__)
+		return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#elif defined(_M_X64)
+		return __umulh(a, b);
+#else
+		const uint64_t aLo{a & 0xFFFFFFFF}, aHi{a >> 32}, bLo{b & 0xFFFFFFFF}, bHi{b >> 32};
+		const auto mid = (aLo * bLo >> 32) + (aHi * bLo & 0xFFFFFFFF) + aLo * bHi;
+		return aHi * bHi + (aHi * bLo >> 32) + (mid >> 32);
+#endif
+	}
+
+	// The engines model UniformRandomBitGenerator, so they can drive the distributions of the Standard Library too.
+	//
+	struct Engine64
+	{
+		using result_type = uint64_t;
+		static constexpr result_type min() noexcept { return 0; }
+		static constexpr result_type max() noexcept { return ~result_type{0}; }
+	};
+
+	// Used only to expand a single seed into the state of the other engines.
+	//
+	inline uint64_t SplitMix64(uint64_t& state) noexcept
+	{
+		auto z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	// https://prng.di.unimi.it/xoshiro256plusplus.c
+	//
+	class Xoshiro256PlusPlus : public Engine64
+	{
+		uint64_t s[4];
+	public:
+		static constexpr const char* Name() noexcept { return "xoshiro256++"; }
+
+		explicit Xoshiro256PlusPlus(uint64_t seed = defaultSeed) noexcept
+		{
+			for (auto& word : s) {
+				word = SplitMix64(seed);
+			}
+		}
+
+		uint64_t operator()() noexcept
+		{
+			const auto result = RotateLeft(s[0] + s[3], 23) + s[0];
+			const auto t = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = RotateLeft(s[3], 45);
+			return result;
+		}
+	};
+
+	// https://github.com/wangyi-fudan/wyhash (wyrand)
+	//
+	class WyRand : public Engine64
+	{
+		uint64_t state;
+	public:
+		static constexpr const char* Name() noexcept { return "wyrand"; }
+
+		explicit WyRand(uint64_t seed = defaultSeed) noexcept : state{seed} {}
+
+		uint64_t operator()() noexcept
+		{
+			state += 0xA0761D6478BD642FULL;
+			const auto other = state ^ 0xE7037ED1A0B428DBULL;
+			return MultiplyHigh(state, other) ^ (state * other);
+		}
+	};
+
+	// {Lanes} independent xoshiro256++ streams advanced together, four lanes per AVX2 register.
+	// Values are produced in batches of {Lanes} and handed out one by one.
+	// Without AVX2 the same lanes are computed by a plain loop, which compilers vectorize to whatever is available.
+	//
+	template<int Lanes>
+	class Xoshiro256PlusPlusLanes : public Engine64
+	{
+		static_assert(Lanes % 4 == 0, "Lanes must be a multiple of the AVX2 register width");
+
+		alignas(32) uint64_t s0[Lanes];
+		alignas(32) uint64_t s1[Lanes];
+		alignas(32) uint64_t s2[Lanes];
+		alignas(32) uint64_t s3[Lanes];
+		alignas(32) uint64_t batch[Lanes];
+		int next{Lanes};
+
+#if defined(__AVX2__)
+		template<int K>
+		static __m256i RotateLeft(__m256i x) noexcept
+		{
+			return _mm256_or_si256(_mm256_slli_epi64(x, K), _mm256_srli_epi64(x, 64 - K));
+		}
+
+		void Refill() noexcept
+		{
+			for (int lane{0}; lane < Lanes; lane += 4)
+			{
+				auto v0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s0 + lane));
+				auto v1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s1 + lane));
+				auto v2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s2 + lane));
+				auto v3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s3 + lane));
+
+				const auto result = _mm256_add_epi64(RotateLeft<23>(_mm256_add_epi64(v0, v3)), v0);
+				const auto t = _mm256_slli_epi64(v1, 17);
+				v2 = _mm256_xor_si256(v2, v0);
+				v3 = _mm256_xor_si256(v3, v1);
+				v1 = _mm256_xor_si256(v1, v2);
+				v0 = _mm256_xor_si256(v0, v3);
+				v2 = _mm256_xor_si256(v2, t);
+				v3 = RotateLeft<45>(v3);
+
+				_mm256_store_si256(reinterpret_cast<__m256i*>(batch + lane), result);
+				_mm256_store_si256(reinterpret_cast<__m256i*>(s0 + lane), v0);
+				_mm256_store_si256(reinterpret_cast<__m256i*>(s1 + lane), v1);
+				_mm256_store_si256(reinterpret_cast<__m256i*>(s2 + lane), v2);
+				_mm256_store_si256(reinterpret_cast<__m256i*>(s3 + lane), v3);
+			}
+		}
+#else
+		void Refill() noexcept
+		{
+			for (int lane{0}; lane < Lanes; ++lane)
+			{
+				batch[lane] = randomengine::RotateLeft(s0[lane] + s3[lane], 23) + s0[lane];
+				const auto t = s1[lane] << 17;
+				s2[lane] ^= s0[lane];
+				s3[lane] ^= s1[lane];
+				s1[lane] ^= s2[lane];
+				s0[lane] ^= s3[lane];
+				s2[lane] ^= t;
+				s3[lane] = randomengine::RotateLeft(s3[lane], 45);
+			}
+		}
+#endif
+
+	public:
+		static const char* Name() noexcept
+		{
+#if defined(__AVX2__)
+			return Lanes == 4 ? "xoshiro256++x4-avx2" : "xoshiro256++x8-avx2";
+#else
+			return Lanes == 4 ? "xoshiro256++x4" : "xoshiro256++x8";
+#endif
+		}
+
+		explicit Xoshiro256PlusPlusLanes(uint64_t seed = defaultSeed) noexcept
+		{
+			for (int lane{0}; lane < Lanes; ++lane) {
+				s0[lane] = SplitMix64(seed);
+				s1[lane] = SplitMix64(seed);
+				s2[lane] = SplitMix64(seed);
+				s3[lane] = SplitMix64(seed);
+			}
+		}
+
+		uint64_t operator()() noexcept
+		{
+			if (next == Lanes) {
+				Refill();
+				next = 0;
+			}
+			return batch[next++];
+		}
+	};
+
+	// Lemire's multiply-shift range reduction: maps a 64-bit random value onto [0, range) without a division.
+	// The rejection step of the original method is skipped; its bias is below range / 2^64.
+	//
+	inline uint64_t BoundedRange(uint64_t random, uint64_t range) noexcept
+	{
+		return MultiplyHigh(random, range);
+	}
+
+	// Uniform double within [0, 1), built from the top 53 bits.
+	//
+	template<typename Engine>
+	double UniformReal(Engine& engine) noexcept
+	{
+		return static_cast<double>(engine() >> 11) / 9007199254740992.0; // 2^53
+	}
+}
+
+// The reference generator: std::mt19937_64 with std::uniform_int_distribution.
+//
+class UniformGenerator
+{
+	std::mt19937_64 engine;
+	std::uniform_int_distribution<> distribution;
+public:
+	static constexpr const char* Name() noexcept { return "mt19937_64"; }
+
+	explicit UniformGenerator(int slots) : distribution{ 1, slots - 1 } {}
+	int64_t operator()() { return distribution(engine); }
+};
+
+template<typename Engine>
+class LemireUniformGenerator
+{
+	Engine engine;
+	uint64_t range;
+public:
+	static const char* Name() noexcept { return Engine::Name(); }
+
+	explicit LemireUniformGenerator(int slots, uint64_t seed = randomengine::defaultSeed) : engine{seed}, range{static_cast<uint64_t>(std::max(slots - 1, 1))} {}
+	int64_t operator()() { return 1 + static_cast<int64_t>(randomengine::BoundedRange(engine(), range)); }
+};
+
+using DefaultUniformGenerator = LemireUniformGenerator<randomengine::Xoshiro256PlusPlus>;
+
+using UniformGenerators = Tag<
+	UniformGenerator,
+	LemireUniformGenerator<randomengine::Xoshiro256PlusPlus>,
+	LemireUniformGenerator<randomengine::WyRand>,
+	LemireUniformGenerator<randomengine::Xoshiro256PlusPlusLanes<4>>,
+	LemireUniformGenerator<randomengine::Xoshiro256PlusPlusLanes<8>>
+>;
+
+inline std::vector<std::string> UniformGeneratorNames()
+{
+	std::vector<std::string> names;
+	ForEachTag(UniformGenerators{}, [&] (auto generatorTag) {
+		names.push_back(decltype(generatorTag)::value_type::Name());
+	});
+	return names;
+}
+
+// Invokes {f} with an instance of the generator named {name}. Returns false if there is no such generator.
+//
+template<typename F>
+bool WithUniformGenerator(const std::string& name, int slots, F f)
+{
+	bool found{false};
+	ForEachTag(UniformGenerators{}, [&] (auto generatorTag)
+	{
+		using GeneratorType = typename decltype(generatorTag)::value_type;
+		if (!found && name == GeneratorType::Name()) {
+			found = true;
+			f(GeneratorType{slots});
+		}
+	});
+	return found;
+}
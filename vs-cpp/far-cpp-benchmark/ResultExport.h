@@ -0,0 +1,343 @@
+#pragma once
+
+// Structured exports of the results, to be ingested by the performance dashboards.
+//
+// A result table is a list of typed columns and the rows of their values. Every export starts with the metadata of the run
+// (the options, the host and the build, see hostinfo::Collect), followed by the table:
+//
+// CSV (RFC 4180): "# key: value" lines of the metadata, the line of the names of the columns, then one line per row.
+//   A list is a single field, its values separated by spaces. Non-finite reals are empty.
+// JSON lines: {"metadata": {...}, "columns": [{"name": ..., "type": ...}, ...]}, then one object per row.
+//   Non-finite reals are null.
+// Columnar binary, for the very large sweeps (little-endian):
+//   header:   "FARCOLS\0" | uint32 version | uint32 metadata count | uint32 column count | uint64 row count
+//   metadata: {metadata count} pairs of strings (key, value), every string stored as uint32 length | bytes (UTF-8)
+//   columns:  for every column, string name | uint8 type | data, the data being:
+//             integer (0): {row count} x int64
+//             real (1):    {row count} x float64
+//             string (2):  uint32 dictionary size | the dictionary of strings | {row count} x uint32 index into the dictionary
+//             real list (3): ({row count} + 1) x uint64 offset | {offset[row count]} x float64 value,
+//                            the values of the row {i} spanning from offset[i] to offset[i+1]
+
+namespace resultexport
+{
+	constexpr char magic[8]{'F', 'A', 'R', 'C', 'O', 'L', 'S', '\0'};
+	constexpr uint32_t version{1};
+
+	using Metadata = std::vector<std::pair<std::string, std::string>>;
+
+	enum class ColumnType : uint8_t
+	{
+		Integer,
+		Real,
+		String,
+		RealList
+	};
+
+	inline const char* ColumnTypeName(ColumnType type)
+	{
+		switch (type) {
+			case ColumnType::Integer: return "integer";
+			case ColumnType::Real: return "real";
+			case ColumnType::String: return "string";
+			default: return "real_list";
+		}
+	}
+
+	struct Column
+	{
+		std::string Name;
+		ColumnType Type;
+	};
+
+	// A value of a cell of the table; only the member of the type of its column is meaningful.
+	//
+	struct Value
+	{
+		int64_t Integer{0};
+		double Real{0};
+		std::string String;
+		std::vector<double> RealList;
+
+		Value(int value) : Integer{value} {}
+		Value(int64_t value) : Integer{value} {}
+		Value(double value) : Real{value} {}
+		Value(const char* value) : String{value} {}
+		Value(std::string value) : String{std::move(value)} {}
+		Value(std::vector<double> value) : RealList{std::move(value)} {}
+	};
+
+	struct ResultTable
+	{
+		std::vector<Column> Columns;
+		std::vector<std::vector<Value>> Rows;
+
+		void AddRow(std::vector<Value> row)
+		{
+			if (row.size() != Columns.size()) {
+				throw std::logic_error{"The row does not match the columns of the table"};
+			}
+			Rows.push_back(std::move(row));
+		}
+	};
+
+	// Shortest text keeping all the precision the timers provide; empty if not finite.
+	//
+	inline std::string FormatReal(double value)
+	{
+		if (!std::isfinite(value)) {
+			return {};
+		}
+		char text[32];
+		std::snprintf(text, sizeof(text), "%.10g", value);
+		return text;
+	}
+
+	inline std::string QuoteCsv(const std::string& field)
+	{
+		if (field.find_first_of(",\"\r\n") == std::string::npos) {
+			return field;
+		}
+		std::string quoted{'"'};
+		for (const auto c : field) {
+			quoted += c;
+			if (c == '"') {
+				quoted += '"';
+			}
+		}
+		return quoted + '"';
+	}
+
+	inline std::string QuoteJson(const std::string& text)
+	{
+		std::string quoted{'"'};
+		for (const auto c : text)
+		{
+			switch (c) {
+				case '"': quoted += "\\\""; break;
+				case '\\': quoted += "\\\\"; break;
+				case '\n': quoted += "\\n"; break;
+				case '\r': quoted += "\\r"; break;
+				case '\t': quoted += "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						char escaped[8];
+						std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+						quoted += escaped;
+					} else {
+						quoted += c;
+					}
+			}
+		}
+		return quoted + '"';
+	}
+
+	inline std::ofstream CreateFile(const std::string& path, std::ios::openmode mode = std::ios::out)
+	{
+		std::ofstream file{path, mode | std::ios::trunc};
+		if (!file) {
+			throw std::runtime_error{"Cannot create export: " + path};
+		}
+		return file;
+	}
+
+	inline void CloseFile(std::ofstream& file, const std::string& path)
+	{
+		file.close();
+		if (!file) {
+			throw std::runtime_error{"Cannot write export: " + path};
+		}
+	}
+
+	inline void WriteCsv(const std::string& path, const Metadata& metadata, const ResultTable& table)
+	{
+		auto file = CreateFile(path);
+
+		for (const auto& entry : metadata) {
+			file << "# " << entry.first << ": " << entry.second << '\n';
+		}
+
+		for (size_t column{0}; column < table.Columns.size(); ++column) {
+			file << (column != 0 ? "," : "") << QuoteCsv(table.Columns[column].Name);
+		}
+		file << '\n';
+
+		for (const auto& row : table.Rows)
+		{
+			for (size_t column{0}; column < table.Columns.size(); ++column)
+			{
+				const auto& value = row[column];
+				if (column != 0) {
+					file << ',';
+				}
+				switch (table.Columns[column].Type) {
+					case ColumnType::Integer:
+						file << value.Integer;
+						break;
+					case ColumnType::Real:
+						file << FormatReal(value.Real);
+						break;
+					case ColumnType::String:
+						file << QuoteCsv(value.String);
+						break;
+					case ColumnType::RealList:
+						for (size_t i{0}; i < value.RealList.size(); ++i) {
+							file << (i != 0 ? " " : "") << FormatReal(value.RealList[i]);
+						}
+						break;
+				}
+			}
+			file << '\n';
+		}
+
+		CloseFile(file, path);
+	}
+
+	inline void WriteJsonLines(const std::string& path, const Metadata& metadata, const ResultTable& table)
+	{
+		auto file = CreateFile(path);
+
+		const auto formatReal = [] (double value) {
+			const auto text = FormatReal(value);
+			return text.empty() ? std::string{"null"} : text;
+		};
+
+		file << "{\"metadata\": {";
+		for (size_t i{0}; i < metadata.size(); ++i) {
+			file << (i != 0 ? ", " : "") << QuoteJson(metadata[i].first) << ": " << QuoteJson(metadata[i].second);
+		}
+		file << "}, \"columns\": [";
+		for (size_t column{0}; column < table.Columns.size(); ++column) {
+			file << (column != 0 ? ", " : "") << "{\"name\": " << QuoteJson(table.Columns[column].Name)
+				<< ", \"type\": \"" << ColumnTypeName(table.Columns[column].Type) << "\"}";
+		}
+		file << "]}\n";
+
+		for (const auto& row : table.Rows)
+		{
+			file << '{';
+			for (size_t column{0}; column < table.Columns.size(); ++column)
+			{
+				const auto& value = row[column];
+				file << (column != 0 ? ", " : "") << QuoteJson(table.Columns[column].Name) << ": ";
+				switch (table.Columns[column].Type) {
+					case ColumnType::Integer:
+						file << value.Integer;
+						break;
+					case ColumnType::Real:
+						file << formatReal(value.Real);
+						break;
+					case ColumnType::String:
+						file << QuoteJson(value.String);
+						break;
+					case ColumnType::RealList:
+						file << '[';
+						for (size_t i{0}; i < value.RealList.size(); ++i) {
+							file << (i != 0 ? ", " : "") << formatReal(value.RealList[i]);
+						}
+						file << ']';
+						break;
+				}
+			}
+			file << "}\n";
+		}
+
+		CloseFile(file, path);
+	}
+
+	class ColumnarWriter
+	{
+		std::ofstream& file;
+
+	public:
+		explicit ColumnarWriter(std::ofstream& file) : file{file} {}
+
+		template<typename T>
+		void Write(T value)
+		{
+			static_assert(std::is_arithmetic<T>::value, "Only the primitive values are written as they are");
+			file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		void Write(const std::string& text)
+		{
+			Write(static_cast<uint32_t>(text.size()));
+			file.write(text.data(), static_cast<std::streamsize>(text.size()));
+		}
+	};
+
+	inline void WriteColumnar(const std::string& path, const Metadata& metadata, const ResultTable& table)
+	{
+		auto file = CreateFile(path, std::ios::binary);
+		auto writer = ColumnarWriter{file};
+
+		file.write(magic, sizeof(magic));
+		writer.Write(version);
+		writer.Write(static_cast<uint32_t>(metadata.size()));
+		writer.Write(static_cast<uint32_t>(table.Columns.size()));
+		writer.Write(static_cast<uint64_t>(table.Rows.size()));
+
+		for (const auto& entry : metadata) {
+			writer.Write(entry.first);
+			writer.Write(entry.second);
+		}
+
+		for (size_t column{0}; column < table.Columns.size(); ++column)
+		{
+			writer.Write(table.Columns[column].Name);
+			writer.Write(static_cast<uint8_t>(table.Columns[column].Type));
+
+			switch (table.Columns[column].Type) {
+				case ColumnType::Integer:
+					for (const auto& row : table.Rows) {
+						writer.Write(row[column].Integer);
+					}
+					break;
+				case ColumnType::Real:
+					for (const auto& row : table.Rows) {
+						writer.Write(row[column].Real);
+					}
+					break;
+				case ColumnType::String: {
+					// The names repeat over the rows, so every distinct one is stored once.
+					//
+					std::vector<const std::string*> dictionary;
+					std::map<std::string, uint32_t> indices;
+					std::vector<uint32_t> rowIndices;
+					for (const auto& row : table.Rows) {
+						const auto& text = row[column].String;
+						const auto insertion = indices.emplace(text, static_cast<uint32_t>(dictionary.size()));
+						if (insertion.second) {
+							dictionary.push_back(&insertion.first->first);
+						}
+						rowIndices.push_back(insertion.first->second);
+					}
+					writer.Write(static_cast<uint32_t>(dictionary.size()));
+					for (const auto text : dictionary) {
+						writer.Write(*text);
+					}
+					for (const auto index : rowIndices) {
+						writer.Write(index);
+					}
+					break;
+				}
+				case ColumnType::RealList: {
+					uint64_t offset{0};
+					writer.Write(offset);
+					for (const auto& row : table.Rows) {
+						offset += row[column].RealList.size();
+						writer.Write(offset);
+					}
+					for (const auto& row : table.Rows) {
+						for (const auto value : row[column].RealList) {
+							writer.Write(value);
+						}
+					}
+					break;
+				}
+			}
+		}
+
+		CloseFile(file, path);
+	}
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+// Robin Hood hashing set: open addressing with linear probing, where a slot being placed takes the place of any slot
+// closer to its home than itself, so the probe lengths stay short and even. Every slot has a byte of metadata: 0 if empty,
+// else 1 + its probe length (its distance from its home), so a lookup stops as soon as it meets a slot closer to home than
+// it has gone. Erasing shifts the following slots of the run back by one, instead of leaving a tombstone, so the toggling of
+// the FAR workload does not wear the table down (unlike google::dense_hash_set), and InitCollection() has nothing to do.
+// The collection has the set-conformant API of SetTag (FindAddRemove.h), i.e. insert(), erase(), size(), and its probe
+// lengths are counted by CountProbeLengths().
+
+namespace robinhood
+{
+	template<typename Key, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>, typename Allocator = std::allocator<Key>>
+	class RobinHoodSet
+	{
+		using MetadataAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<uint8_t>;
+
+		static constexpr size_t minCapacity{16};
+		static constexpr unsigned maxMetadata{std::numeric_limits<uint8_t>::max()};
+		static constexpr size_t npos{~size_t{0}};
+
+		std::vector<uint8_t, MetadataAllocator> metadata; // 0 if empty, else 1 + the probe length of the slot.
+		std::vector<Key, Allocator> slots;
+		size_t mask{0}; // The capacity (a power of 2) minus 1.
+		size_t count{0};
+		Hash hasher;
+		Equal equal;
+
+		// The standard hashes of the integers are mostly the identity, so the bits are mixed (as in MurmurHash3 fmix64).
+		//
+		size_t Home(const Key& key) const
+		{
+			auto h = static_cast<uint64_t>(hasher(key));
+			h ^= h >> 33;
+			h *= 0xFF51AFD7ED558CCDULL;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ULL;
+			h ^= h >> 33;
+			return static_cast<size_t>(h) & mask;
+		}
+
+		size_t Capacity() const noexcept
+		{
+			return slots.size();
+		}
+
+		size_t Find(const Key& key) const
+		{
+			auto index = Home(key);
+			for (unsigned probe{1};; ++probe, index = (index + 1) & mask)
+			{
+				if (metadata[index] < probe) {
+					return npos;
+				}
+				if (metadata[index] == probe && equal(slots[index], key)) {
+					return index;
+				}
+			}
+		}
+
+		// Places {key} (not present), robbing the slots closer to their homes on the way, and returns where it went.
+		// Returns npos if a probe would get too long for the metadata, leaving the slot in hand (maybe a robbed one) in {key}.
+		//
+		size_t Place(Key& key)
+		{
+			auto placed = npos;
+			auto index = Home(key);
+			for (unsigned probe{1}; probe < maxMetadata; ++probe, index = (index + 1) & mask)
+			{
+				if (metadata[index] == 0) {
+					metadata[index] = static_cast<uint8_t>(probe);
+					slots[index] = std::move(key);
+					return placed != npos ? placed : index;
+				}
+				if (metadata[index] < probe) {
+					const auto robbed = static_cast<unsigned>(metadata[index]);
+					metadata[index] = static_cast<uint8_t>(probe);
+					probe = robbed;
+					std::swap(slots[index], key);
+					placed = placed != npos ? placed : index;
+				}
+			}
+			return npos;
+		}
+
+		void Rehash(size_t capacity)
+		{
+			auto oldMetadata = std::move(metadata);
+			auto oldSlots = std::move(slots);
+			metadata.assign(capacity, 0);
+			slots.assign(capacity, Key{});
+			mask = capacity - 1;
+
+			for (size_t i{0}; i < oldMetadata.size(); ++i) {
+				if (oldMetadata[i] != 0) {
+					PlaceOrGrow(oldSlots[i]);
+				}
+			}
+		}
+
+		void PlaceOrGrow(Key& key)
+		{
+			while (Place(key) == npos) {
+				Rehash(Capacity() * 2);
+			}
+		}
+
+	public:
+		struct iterator
+		{
+			const Key* Slot;
+			size_t Index;
+
+			const Key& operator*() const noexcept
+			{
+				return *Slot;
+			}
+		};
+
+		RobinHoodSet()
+		{
+			Rehash(minCapacity);
+		}
+
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		// Adds {key} unless present; returns where it is and whether it was added.
+		//
+		std::pair<iterator, bool> insert(const Key& key)
+		{
+			const auto found = Find(key);
+			if (found != npos) {
+				return {{&slots[found], found}, false};
+			}
+
+			// The load is kept within 7/8.
+			//
+			if (count + 1 > Capacity() - Capacity() / 8) {
+				Rehash(Capacity() * 2);
+			}
+			auto placed = key;
+			auto index = Place(placed);
+			if (index == npos) {
+				PlaceOrGrow(placed);
+				index = Find(key);
+			}
+			++count;
+			return {{&slots[index], index}, true};
+		}
+
+		void erase(iterator position)
+		{
+			auto index = position.Index;
+			for (auto next = (index + 1) & mask; metadata[next] > 1; index = next, next = (next + 1) & mask)
+			{
+				slots[index] = std::move(slots[next]);
+				metadata[index] = static_cast<uint8_t>(metadata[next] - 1);
+			}
+			slots[index] = Key{};
+			metadata[index] = 0;
+			--count;
+		}
+
+		void CountProbeLengths(ProbeLengthCounts& counts) const
+		{
+			for (const auto m : metadata) {
+				if (m != 0) {
+					++counts[std::min<size_t>(m - 1u, counts.size() - 1)];
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+// Runs independent benchmark jobs concurrently, one per pinned core.
+//
+// The results are returned in the order of the jobs, whatever order they complete in, so that the report does not
+// depend on the scheduling.
+
+namespace scheduler
+{
+	// Logical processors the process is allowed to run on.
+	//
+	inline std::vector<int> AvailableCores()
+	{
+		std::vector<int> cores;
+#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+			for (int core{0}; core < CPU_SETSIZE; ++core) {
+				if (CPU_ISSET(core, &set)) {
+					cores.push_back(core);
+				}
+			}
+		}
+#elif defined(_WIN32)
+		DWORD_PTR processMask, systemMask;
+		if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+			for (int core{0}; core < static_cast<int>(sizeof(DWORD_PTR) * 8); ++core) {
+				if (processMask & (DWORD_PTR{1} << core)) {
+					cores.push_back(core);
+				}
+			}
+		}
+#endif
+		if (cores.empty()) {
+			for (int core{0}; core < static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)); ++core) {
+				cores.push_back(core);
+			}
+		}
+		return cores;
+	}
+
+	// Parses a list of logical processors, such as "0,2,4-7".
+	//
+	inline std::vector<int> ParseCoreList(const std::string& text)
+	{
+		std::vector<int> cores;
+		std::istringstream stream{text};
+		for (std::string range; std::getline(stream, range, ',');)
+		{
+			if (range.empty()) {
+				continue;
+			}
+			const auto dash = range.find('-');
+			const auto first = std::stoi(range.substr(0, dash));
+			const auto last = dash != std::string::npos ? std::stoi(range.substr(dash + 1)) : first;
+			for (int core{first}; core <= last; ++core) {
+				cores.push_back(core);
+			}
+		}
+		return cores;
+	}
+
+	// Logical processors sharing the physical core with {core} (including {core} itself).
+	//
+	inline std::vector<int> SmtSiblingsOf(int core)
+	{
+#if defined(__linux__)
+		std::ifstream file{"/sys/devices/system/cpu/cpu" + std::to_string(core) + "/topology/thread_siblings_list"};
+		std::string list;
+		if (std::getline(file, list)) {
+			auto siblings = ParseCoreList(list);
+			if (!siblings.empty()) {
+				return siblings;
+			}
+		}
+#elif defined(_WIN32)
+		DWORD bytes{0};
+		GetLogicalProcessorInformation(nullptr, &bytes);
+		std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(bytes / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+		if (!infos.empty() && GetLogicalProcessorInformation(infos.data(), &bytes)) {
+			for (const auto& info : infos) {
+				if (info.Relationship == RelationProcessorCore && (info.ProcessorMask & (ULONG_PTR{1} << core))) {
+					std::vector<int> siblings;
+					for (int sibling{0}; sibling < static_cast<int>(sizeof(ULONG_PTR) * 8); ++sibling) {
+						if (info.ProcessorMask & (ULONG_PTR{1} << sibling)) {
+							siblings.push_back(sibling);
+						}
+					}
+					return siblings;
+				}
+			}
+		}
+#endif
+		return {core};
+	}
+
+	// Keeps only the first logical processor of every physical core, so that the others stay idle.
+	//
+	inline std::vector<int> WithoutSmtSiblings(const std::vector<int>& cores)
+	{
+		std::vector<int> result;
+		for (const auto core : cores) {
+			const auto siblings = SmtSiblingsOf(core);
+			const auto taken = std::any_of(std::begin(result), std::end(result), [&] (int other) {
+				return std::find(std::begin(siblings), std::end(siblings), other) != std::end(siblings);
+			});
+			if (!taken) {
+				result.push_back(core);
+			}
+		}
+		return result;
+	}
+
+	// Returns false if the thread could not be pinned (it keeps running wherever the OS puts it).
+	//
+	inline bool PinCurrentThread(int core)
+	{
+#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(core, &set);
+		return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+		return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << core) != 0;
+#else
+		return false;
+#endif
+	}
+
+	// Runs {jobs} and returns their results in the same order, calling {onDone} (serialized) after every job.
+	//
+	// With no {cores}, the jobs run one after another on the calling thread. Otherwise, every core gets a pinned worker
+	// which picks the next pending job as soon as it finishes the previous one.
+	//
+	// If {noisyNeighbours}, the jobs still run one after another, on the first core, but every other core keeps running
+	// a copy of the same job (whose result is discarded) meanwhile, so that the measured one competes for the shared cache
+	// and memory bandwidth. The neighbours are not interrupted, so a job ends only when all its copies do.
+	//
+	template<typename Result, typename F>
+	std::vector<Result> RunJobs(const std::vector<std::function<Result()>>& jobs, const std::vector<int>& cores, bool noisyNeighbours, F onDone)
+	{
+		std::vector<Result> results(jobs.size());
+
+		if (cores.empty()) {
+			for (size_t job{0}; job < jobs.size(); ++job) {
+				results[job] = jobs[job]();
+				onDone();
+			}
+			return results;
+		}
+
+		std::mutex mutex;
+		std::exception_ptr failure;
+		const auto guarded = [&] (int core, auto body) {
+			return [&, core, body] {
+				PinCurrentThread(core);
+				try {
+					body();
+				} catch (...) {
+					std::lock_guard<std::mutex> lock{mutex};
+					failure = std::current_exception();
+				}
+			};
+		};
+
+		if (noisyNeighbours)
+		{
+			for (size_t job{0}; job < jobs.size() && !failure; ++job)
+			{
+				std::atomic<bool> done{false};
+				std::atomic<int> ready{0};
+
+				std::vector<std::thread> threads;
+				for (size_t neighbour{1}; neighbour < cores.size(); ++neighbour) {
+					threads.emplace_back(guarded(cores[neighbour], [&] {
+						++ready;
+						while (!done) {
+							jobs[job]();
+						}
+					}));
+				}
+				threads.emplace_back(guarded(cores.front(), [&] {
+					while (ready != static_cast<int>(cores.size()) - 1) {
+						std::this_thread::yield();
+					}
+					try {
+						results[job] = jobs[job]();
+					} catch (...) {
+						done = true;
+						throw;
+					}
+					done = true;
+				}));
+
+				for (auto& thread : threads) {
+					thread.join();
+				}
+				onDone();
+			}
+		}
+		else
+		{
+			std::atomic<size_t> next{0};
+			std::vector<std::thread> threads;
+			for (const auto core : cores) {
+				threads.emplace_back(guarded(core, [&] {
+					for (auto job = next++; job < jobs.size(); job = next++) {
+						auto result = jobs[job]();
+						std::lock_guard<std::mutex> lock{mutex};
+						results[job] = std::move(result);
+						onDone();
+					}
+				}));
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+		}
+
+		if (failure) {
+			std::rethrow_exception(failure);
+		}
+		return results;
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+// Set partitioned by the hash of the key into {Shards} independent sub-sets of type {Inner}, each guarded by its own mutex.
+//
+// Every shard (its mutex, collection and size) is aligned to a cache line, so that the threads working on different shards
+// do not share a line. The shard is chosen by the high bits of a multiplicative hash by default, so that it does not correlate
+// with the low bits the inner hash sets use to pick a bucket.
+//
+// Offers the same interface as LockFreeHashSet, i.e. contains(), insert(), erase(), toggle() and size().
+
+struct ShardHash
+{
+	size_t operator()(uint64_t key) const noexcept
+	{
+		return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+	}
+};
+
+template<typename Inner, int Shards, typename Hash = ShardHash>
+class ShardedSet
+{
+	static_assert(Shards > 0, "At least one shard is required");
+
+	struct alignas(64) Shard
+	{
+		std::mutex Mutex;
+		Inner Collection;
+		decltype(InitCollection(std::declval<Inner&>())) CollectionAux{InitCollection(Collection)};
+		std::atomic<int64_t> Size{0}; // Written under the mutex only, but read by size() without it.
+	};
+
+	std::unique_ptr<Shard[]> shards{std::make_unique<Shard[]>(Shards)};
+
+	Shard& ShardOf(typename Inner::value_type key) const noexcept
+	{
+		return shards[Hash{}(static_cast<uint64_t>(key)) % Shards];
+	}
+
+	static void Resize(Shard& shard, int64_t delta) noexcept
+	{
+		shard.Size.store(shard.Size.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+	}
+
+public:
+	using value_type = typename Inner::value_type;
+
+	bool contains(value_type key) const
+	{
+		auto& shard = ShardOf(key);
+		std::lock_guard<std::mutex> lock{shard.Mutex};
+		return shard.Collection.find(key) != shard.Collection.end();
+	}
+
+	// Each returns true if the set has changed.
+	//
+	bool insert(value_type key)
+	{
+		auto& shard = ShardOf(key);
+		std::lock_guard<std::mutex> lock{shard.Mutex};
+		if (!shard.Collection.insert(key).second) {
+			return false;
+		}
+		Resize(shard, 1);
+		return true;
+	}
+
+	bool erase(value_type key)
+	{
+		auto& shard = ShardOf(key);
+		std::lock_guard<std::mutex> lock{shard.Mutex};
+		auto finding = shard.Collection.find(key);
+		if (finding == shard.Collection.end()) {
+			return false;
+		}
+		shard.Collection.erase(finding);
+		Resize(shard, -1);
+		return true;
+	}
+
+	// Adds the key if absent, removes it otherwise. Returns true if the key is present afterwards.
+	//
+	bool toggle(value_type key)
+	{
+		auto& shard = ShardOf(key);
+		std::lock_guard<std::mutex> lock{shard.Mutex};
+		auto insertion{shard.Collection.insert(key)};
+		if (!insertion.second) {
+			shard.Collection.erase(insertion.first);
+			Resize(shard, -1);
+			return false;
+		}
+		Resize(shard, 1);
+		return true;
+	}
+
+	// Exact only while no other thread modifies the set.
+	//
+	int64_t size() const noexcept
+	{
+		int64_t size{0};
+		for (int shard{0}; shard < Shards; ++shard) {
+			size += shards[shard].Size.load(std::memory_order_relaxed);
+		}
+		return size;
+	}
+};
@@ -0,0 +1,303 @@
+#pragma once
+
+// Linear search of the unsorted sequences of slots of a primitive type, comparing a whole vector of keys at once
+// (SSE2, AVX2 or AVX-512, the widest one the CPU supports, chosen at runtime), with the slot removed by moving the last one
+// into its place, as the order does not matter. The kernels are compiled for their instruction sets regardless of the flags
+// of the build, and so is the whole game loop using them, so that they are inlined into it: the instruction set is
+// dispatched once per game, not once per turn.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FAR_SIMD_SEARCH
+#endif
+
+#if defined(_MSC_VER)
+#define FAR_TARGET(isa)
+#define FAR_ALWAYS_INLINE __forceinline
+#else
+#define FAR_TARGET(isa) __attribute__((target(isa)))
+#define FAR_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
+template<typename... T> struct SequenceUnsortedSimdTag : public Tag<T...> { };
+
+namespace simdsearch
+{
+	enum class InstructionSet
+	{
+		Scalar,
+		Sse2,
+		Avx2,
+		Avx512 // F and BW.
+	};
+
+	inline InstructionSet DetectInstructionSet()
+	{
+#if defined(FAR_SIMD_SEARCH) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const auto maxLeaf = info[0];
+		__cpuid(info, 1);
+		const bool osSavesAvx = ((info[2] >> 27) & 1) != 0 && ((info[2] >> 28) & 1) != 0 && (_xgetbv(0) & 0x06) == 0x06;
+		if (!osSavesAvx || maxLeaf < 7) {
+			return InstructionSet::Sse2;
+		}
+		__cpuidex(info, 7, 0);
+		if (((info[1] >> 16) & 1) != 0 && ((info[1] >> 30) & 1) != 0 && (_xgetbv(0) & 0xE6) == 0xE6) {
+			return InstructionSet::Avx512;
+		}
+		return ((info[1] >> 5) & 1) != 0 ? InstructionSet::Avx2 : InstructionSet::Sse2;
+#elif defined(FAR_SIMD_SEARCH)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+			return InstructionSet::Avx512;
+		}
+		return __builtin_cpu_supports("avx2") ? InstructionSet::Avx2 : InstructionSet::Sse2;
+#else
+		return InstructionSet::Scalar;
+#endif
+	}
+
+	inline InstructionSet SupportedInstructionSet()
+	{
+		static const auto instructionSet = DetectInstructionSet();
+		return instructionSet;
+	}
+
+	inline const char* InstructionSetName(InstructionSet instructionSet)
+	{
+		switch (instructionSet) {
+			case InstructionSet::Sse2: return "sse2";
+			case InstructionSet::Avx2: return "avx2";
+			case InstructionSet::Avx512: return "avx512";
+			default: return "scalar";
+		}
+	}
+
+	inline unsigned LowestSetBit(uint64_t mask) noexcept
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, mask);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+	}
+
+	// The index of {key} among the {count} {keys}, or {count} if absent.
+	//
+	template<typename T>
+	size_t FindScalar(const T* keys, size_t count, T key)
+	{
+		for (size_t i{0}; i < count; ++i) {
+			if (keys[i] == key) {
+				return i;
+			}
+		}
+		return count;
+	}
+
+#if defined(FAR_SIMD_SEARCH)
+	// Lanes of the keys of {Size} bytes: the key broadcast to all of them, and the mask of the bytes of the lanes equal to it
+	// (AVX-512: of the lanes themselves).
+	//
+	template<size_t Size> struct Sse2Lanes;
+	template<size_t Size> struct Avx2Lanes;
+	template<size_t Size> struct Avx512Lanes;
+
+	template<> struct Sse2Lanes<1>
+	{
+		FAR_TARGET("sse2") static __m128i Broadcast(int8_t key) { return _mm_set1_epi8(key); }
+		FAR_TARGET("sse2") static uint64_t Equal(__m128i keys, __m128i key) { return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(keys, key))); }
+	};
+
+	template<> struct Sse2Lanes<2>
+	{
+		FAR_TARGET("sse2") static __m128i Broadcast(int16_t key) { return _mm_set1_epi16(key); }
+		FAR_TARGET("sse2") static uint64_t Equal(__m128i keys, __m128i key) { return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(keys, key))); }
+	};
+
+	template<> struct Sse2Lanes<4>
+	{
+		FAR_TARGET("sse2") static __m128i Broadcast(int32_t key) { return _mm_set1_epi32(key); }
+		FAR_TARGET("sse2") static uint64_t Equal(__m128i keys, __m128i key) { return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi32(keys, key))); }
+	};
+
+	template<> struct Sse2Lanes<8>
+	{
+		FAR_TARGET("sse2") static __m128i Broadcast(int64_t key) { return _mm_set1_epi64x(key); }
+
+		// SSE2 has no 64-bit comparison: both halves of the lane must be equal.
+		//
+		FAR_TARGET("sse2") static uint64_t Equal(__m128i keys, __m128i key)
+		{
+			const auto halves = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi32(keys, key)));
+			return halves & (halves >> 4) & 0x0F0F;
+		}
+	};
+
+	template<> struct Avx2Lanes<1>
+	{
+		FAR_TARGET("avx2") static __m256i Broadcast(int8_t key) { return _mm256_set1_epi8(key); }
+		FAR_TARGET("avx2") static uint64_t Equal(__m256i keys, __m256i key) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(keys, key))); }
+	};
+
+	template<> struct Avx2Lanes<2>
+	{
+		FAR_TARGET("avx2") static __m256i Broadcast(int16_t key) { return _mm256_set1_epi16(key); }
+		FAR_TARGET("avx2") static uint64_t Equal(__m256i keys, __m256i key) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(keys, key))); }
+	};
+
+	template<> struct Avx2Lanes<4>
+	{
+		FAR_TARGET("avx2") static __m256i Broadcast(int32_t key) { return _mm256_set1_epi32(key); }
+		FAR_TARGET("avx2") static uint64_t Equal(__m256i keys, __m256i key) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(keys, key))); }
+	};
+
+	template<> struct Avx2Lanes<8>
+	{
+		FAR_TARGET("avx2") static __m256i Broadcast(int64_t key) { return _mm256_set1_epi64x(key); }
+		FAR_TARGET("avx2") static uint64_t Equal(__m256i keys, __m256i key) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi64(keys, key))); }
+	};
+
+	template<> struct Avx512Lanes<1>
+	{
+		FAR_TARGET("avx512f,avx512bw") static __m512i Broadcast(int8_t key) { return _mm512_set1_epi8(key); }
+		FAR_TARGET("avx512f,avx512bw") static uint64_t Equal(__m512i keys, __m512i key) { return _mm512_cmpeq_epi8_mask(keys, key); }
+	};
+
+	template<> struct Avx512Lanes<2>
+	{
+		FAR_TARGET("avx512f,avx512bw") static __m512i Broadcast(int16_t key) { return _mm512_set1_epi16(key); }
+		FAR_TARGET("avx512f,avx512bw") static uint64_t Equal(__m512i keys, __m512i key) { return _mm512_cmpeq_epi16_mask(keys, key); }
+	};
+
+	template<> struct Avx512Lanes<4>
+	{
+		FAR_TARGET("avx512f,avx512bw") static __m512i Broadcast(int32_t key) { return _mm512_set1_epi32(key); }
+		FAR_TARGET("avx512f,avx512bw") static uint64_t Equal(__m512i keys, __m512i key) { return _mm512_cmpeq_epi32_mask(keys, key); }
+	};
+
+	template<> struct Avx512Lanes<8>
+	{
+		FAR_TARGET("avx512f,avx512bw") static __m512i Broadcast(int64_t key) { return _mm512_set1_epi64(key); }
+		FAR_TARGET("avx512f,avx512bw") static uint64_t Equal(__m512i keys, __m512i key) { return _mm512_cmpeq_epi64_mask(keys, key); }
+	};
+
+	template<typename T>
+	using SignedKey = std::make_signed_t<T>;
+
+	template<typename T>
+	FAR_TARGET("sse2") inline size_t FindSse2(const T* keys, size_t count, T key)
+	{
+		using Lanes = Sse2Lanes<sizeof(T)>;
+		const auto broadcast = Lanes::Broadcast(static_cast<SignedKey<T>>(key));
+		size_t i{0};
+		for (; i + 16 / sizeof(T) <= count; i += 16 / sizeof(T)) {
+			const auto equal = Lanes::Equal(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), broadcast);
+			if (equal != 0) {
+				return i + LowestSetBit(equal) / sizeof(T);
+			}
+		}
+		return i + FindScalar(keys + i, count - i, key);
+	}
+
+	template<typename T>
+	FAR_TARGET("avx2") inline size_t FindAvx2(const T* keys, size_t count, T key)
+	{
+		using Lanes = Avx2Lanes<sizeof(T)>;
+		const auto broadcast = Lanes::Broadcast(static_cast<SignedKey<T>>(key));
+		size_t i{0};
+		for (; i + 32 / sizeof(T) <= count; i += 32 / sizeof(T)) {
+			const auto equal = Lanes::Equal(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), broadcast);
+			if (equal != 0) {
+				return i + LowestSetBit(equal) / sizeof(T);
+			}
+		}
+		return i + FindSse2(keys + i, count - i, key);
+	}
+
+	template<typename T>
+	FAR_TARGET("avx512f,avx512bw") inline size_t FindAvx512(const T* keys, size_t count, T key)
+	{
+		using Lanes = Avx512Lanes<sizeof(T)>;
+		const auto broadcast = Lanes::Broadcast(static_cast<SignedKey<T>>(key));
+		size_t i{0};
+		for (; i + 64 / sizeof(T) <= count; i += 64 / sizeof(T)) {
+			const auto equal = Lanes::Equal(_mm512_loadu_si512(keys + i), broadcast);
+			if (equal != 0) {
+				return i + LowestSetBit(equal);
+			}
+		}
+		return i + FindAvx2(keys + i, count - i, key);
+	}
+#endif
+
+	// The game loop with the search {Find}. It has no instruction set of its own: it is inlined into an entry point compiled
+	// for the instruction set of {Find}, so that the search can be inlined in turn.
+	//
+	template<typename SequenceType, size_t (*Find)(const typename SequenceType::value_type*, size_t, typename SequenceType::value_type), typename RandomGenerator>
+	FAR_ALWAYS_INLINE GameResult PlayWithFind(int turns, RandomGenerator& randomGenerator)
+	{
+		using PrimitiveType = typename SequenceType::value_type;
+
+		auto collection{SequenceType{}};
+		int64_t sumOfSizes{0};
+
+		for (int turn{0}; turn < turns; ++turn)
+		{
+			const auto slot{static_cast<PrimitiveType>(randomGenerator())};
+			const auto index{Find(collection.data(), collection.size(), slot)};
+			if (index != collection.size()) {
+				collection[index] = collection.back();
+				collection.pop_back();
+			} else {
+				collection.push_back(slot);
+			}
+			sumOfSizes += collection.size();
+		}
+
+		return EndOfGame(sumOfSizes, static_cast<int64_t>(collection.size()));
+	}
+
+	template<typename SequenceType, typename RandomGenerator>
+	GameResult PlayScalar(int turns, RandomGenerator& randomGenerator)
+	{
+		return PlayWithFind<SequenceType, FindScalar<typename SequenceType::value_type>>(turns, randomGenerator);
+	}
+
+#if defined(FAR_SIMD_SEARCH)
+	template<typename SequenceType, typename RandomGenerator>
+	FAR_TARGET("sse2") GameResult PlaySse2(int turns, RandomGenerator& randomGenerator)
+	{
+		return PlayWithFind<SequenceType, FindSse2<typename SequenceType::value_type>>(turns, randomGenerator);
+	}
+
+	template<typename SequenceType, typename RandomGenerator>
+	FAR_TARGET("avx2") GameResult PlayAvx2(int turns, RandomGenerator& randomGenerator)
+	{
+		return PlayWithFind<SequenceType, FindAvx2<typename SequenceType::value_type>>(turns, randomGenerator);
+	}
+
+	template<typename SequenceType, typename RandomGenerator>
+	FAR_TARGET("avx512f,avx512bw") GameResult PlayAvx512(int turns, RandomGenerator& randomGenerator)
+	{
+		return PlayWithFind<SequenceType, FindAvx512<typename SequenceType::value_type>>(turns, randomGenerator);
+	}
+#endif
+}
+
+// The collection is a contiguous std::vector-like sequence of the slots themselves, i.e. data(), size(), push_back(), pop_back().
+//
+template<typename RandomGenerator, typename SequenceType, typename PrimitiveType>
+GameResult PlayFindAddRemove(int turns, int slots, RandomGenerator randomGenerator, SequenceUnsortedSimdTag<SequenceType>, Tag<PrimitiveAllocMethod<PrimitiveType>>)
+{
+	switch (simdsearch::SupportedInstructionSet()) {
+#if defined(FAR_SIMD_SEARCH)
+		case simdsearch::InstructionSet::Avx512: return simdsearch::PlayAvx512<SequenceType>(turns, randomGenerator);
+		case simdsearch::InstructionSet::Avx2: return simdsearch::PlayAvx2<SequenceType>(turns, randomGenerator);
+		case simdsearch::InstructionSet::Sse2: return simdsearch::PlaySse2<SequenceType>(turns, randomGenerator);
+#endif
+		default: return simdsearch::PlayScalar<SequenceType>(turns, randomGenerator);
+	}
+}
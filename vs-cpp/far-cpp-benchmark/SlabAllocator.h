@@ -0,0 +1,236 @@
+#pragma once
+
+// Thread-caching slab allocator for the nodes of the collections, in the manner of tcmalloc.
+//
+// The small blocks are sorted into size classes (multiples of 16 bytes, up to 256 bytes). Every thread keeps a free list
+// of every class, so that allocating and freeing are a pop and a push, without a lock. An empty list is refilled
+// with a batch of blocks from the central pool of the class (under its lock), which carves new slabs if it runs out;
+// a list grown too long gives a batch back. The slabs are only released at exit. The larger blocks go to the heap.
+// The memory profile counts the blocks handed out, at the size of their class, and not the slabs.
+
+namespace slaballocator
+{
+	constexpr size_t classGranularity{16};
+	constexpr size_t classes{16};
+	constexpr size_t maxClassBytes{classGranularity * classes};
+	constexpr int batchSize{64};
+	constexpr size_t slabBytes{64 * 1024};
+
+	struct FreeBlock
+	{
+		FreeBlock* Next;
+	};
+
+	struct Batch
+	{
+		FreeBlock* Head;
+		int Count;
+	};
+
+	class CentralPool
+	{
+		struct SizeClass
+		{
+			std::mutex Mutex;
+			std::vector<Batch> Batches;
+		};
+
+		SizeClass sizeClasses[classes];
+		std::mutex slabsMutex;
+		std::vector<void*> slabs;
+
+		// Cuts a new slab into the blocks of the class, keeping one batch and caching the others.
+		//
+		Batch Carve(size_t sizeClass)
+		{
+			const auto blockBytes = (sizeClass + 1) * classGranularity;
+			const auto blocks = static_cast<int>(slabBytes / blockBytes);
+			const auto slab = static_cast<char*>(std::malloc(slabBytes));
+			if (slab == nullptr) {
+				throw std::bad_alloc{};
+			}
+			{
+				std::lock_guard<std::mutex> lock{slabsMutex};
+				slabs.push_back(slab);
+			}
+
+			std::vector<Batch> batches;
+			for (int first{0}; first < blocks; first += batchSize)
+			{
+				const auto count = std::min(batchSize, blocks - first);
+				for (int i{0}; i < count; ++i) {
+					const auto block = reinterpret_cast<FreeBlock*>(slab + (first + i) * blockBytes);
+					block->Next = i + 1 < count ? reinterpret_cast<FreeBlock*>(slab + (first + i + 1) * blockBytes) : nullptr;
+				}
+				batches.push_back({reinterpret_cast<FreeBlock*>(slab + first * blockBytes), count});
+			}
+
+			const auto batch = batches.back();
+			batches.pop_back();
+
+			auto& pool = sizeClasses[sizeClass];
+			std::lock_guard<std::mutex> lock{pool.Mutex};
+			pool.Batches.insert(std::end(pool.Batches), std::begin(batches), std::end(batches));
+			return batch;
+		}
+
+	public:
+		CentralPool() = default;
+		CentralPool(const CentralPool&) = delete;
+		CentralPool& operator=(const CentralPool&) = delete;
+
+		~CentralPool()
+		{
+			for (const auto slab : slabs) {
+				std::free(slab);
+			}
+		}
+
+		Batch TakeBatch(size_t sizeClass)
+		{
+			{
+				auto& pool = sizeClasses[sizeClass];
+				std::lock_guard<std::mutex> lock{pool.Mutex};
+				if (!pool.Batches.empty()) {
+					const auto batch = pool.Batches.back();
+					pool.Batches.pop_back();
+					return batch;
+				}
+			}
+			return Carve(sizeClass);
+		}
+
+		void ReturnBatch(size_t sizeClass, Batch batch)
+		{
+			auto& pool = sizeClasses[sizeClass];
+			std::lock_guard<std::mutex> lock{pool.Mutex};
+			pool.Batches.push_back(batch);
+		}
+	};
+
+	inline CentralPool& Central()
+	{
+		static CentralPool pool;
+		return pool;
+	}
+
+	class ThreadCache
+	{
+		FreeBlock* lists[classes]{};
+		int counts[classes]{};
+
+	public:
+		ThreadCache() = default;
+		ThreadCache(const ThreadCache&) = delete;
+		ThreadCache& operator=(const ThreadCache&) = delete;
+
+		// The blocks go back to the central pool when the thread ends.
+		//
+		~ThreadCache()
+		{
+			for (size_t sizeClass{0}; sizeClass < classes; ++sizeClass) {
+				if (counts[sizeClass] != 0) {
+					Central().ReturnBatch(sizeClass, {lists[sizeClass], counts[sizeClass]});
+				}
+			}
+		}
+
+		void* Allocate(size_t sizeClass)
+		{
+			if (counts[sizeClass] == 0) {
+				const auto batch = Central().TakeBatch(sizeClass);
+				lists[sizeClass] = batch.Head;
+				counts[sizeClass] = batch.Count;
+			}
+
+			const auto block = lists[sizeClass];
+			lists[sizeClass] = block->Next;
+			--counts[sizeClass];
+			return block;
+		}
+
+		void Free(void* p, size_t sizeClass)
+		{
+			const auto block = static_cast<FreeBlock*>(p);
+			block->Next = lists[sizeClass];
+			lists[sizeClass] = block;
+
+			if (++counts[sizeClass] >= 2 * batchSize)
+			{
+				auto last = block;
+				for (int i{1}; i < batchSize; ++i) {
+					last = last->Next;
+				}
+				lists[sizeClass] = last->Next;
+				last->Next = nullptr;
+				counts[sizeClass] -= batchSize;
+				Central().ReturnBatch(sizeClass, {block, batchSize});
+			}
+		}
+	};
+
+	inline ThreadCache& LocalCache()
+	{
+		thread_local ThreadCache cache;
+		return cache;
+	}
+
+	// The blocks of the classes are aligned to (at least) 16 bytes, like the ones of the heap.
+	//
+	inline bool IsSmall(size_t bytes, size_t alignment) noexcept
+	{
+		return bytes <= maxClassBytes && alignment <= classGranularity;
+	}
+
+	inline size_t SizeClassOf(size_t bytes) noexcept
+	{
+		return bytes != 0 ? (bytes - 1) / classGranularity : 0;
+	}
+
+	template<typename T>
+	class SlabAllocator
+	{
+	public:
+		using value_type = T;
+
+		template<typename U>
+		struct rebind
+		{
+			using other = SlabAllocator<U>;
+		};
+
+		SlabAllocator() noexcept = default;
+
+		template<typename U>
+		SlabAllocator(const SlabAllocator<U>&) noexcept { }
+
+		T* allocate(size_t n)
+		{
+			const auto bytes = n * sizeof(T);
+			if (IsSmall(bytes, alignof(T))) {
+				const auto sizeClass = SizeClassOf(bytes);
+				memoryprofile::CountAllocated((sizeClass + 1) * classGranularity);
+				return static_cast<T*>(LocalCache().Allocate(sizeClass));
+			}
+			return static_cast<T*>(::operator new(bytes));
+		}
+
+		void deallocate(T* p, size_t n) noexcept
+		{
+			const auto bytes = n * sizeof(T);
+			if (IsSmall(bytes, alignof(T))) {
+				const auto sizeClass = SizeClassOf(bytes);
+				memoryprofile::CountFreed((sizeClass + 1) * classGranularity);
+				LocalCache().Free(p, sizeClass);
+			} else {
+				::operator delete(p);
+			}
+		}
+
+		template<typename U>
+		bool operator==(const SlabAllocator<U>&) const noexcept { return true; }
+
+		template<typename U>
+		bool operator!=(const SlabAllocator<U>&) const noexcept { return false; }
+	};
+}
@@ -0,0 +1,341 @@
+#pragma once
+
+// Methods of allocating the slots of the container-based algorithms, where the element of the collection only refers to the slot.
+// PrimitiveAllocMethod (FindAddRemove.h) stores the slot itself.
+
+namespace slotallocmethod
+{
+	struct less_dereference
+	{
+		template<typename PtrType>
+		constexpr bool operator()(const PtrType& a, const PtrType& b) const
+		{
+			return *a < *b;
+		}
+	};
+
+	struct equal_dereference
+	{
+		using is_transparent = std::true_type;
+
+		template<typename PtrType>
+		bool operator()(const PtrType& a, const PtrType& b) const
+		{
+			return *a == *b;
+		}
+	};
+
+	struct hash_dereference
+	{
+		template<typename PtrType>
+		std::size_t operator()(const PtrType& p) const
+		{
+			return std::hash<std::remove_reference_t<decltype(*p)>>{}(*p);
+		}
+	};
+
+
+	template<typename T>
+	class NewAllocMethod
+	{
+	public:
+		using PrimitiveType = T;
+		using ElementType = T*;
+
+		using Less = less_dereference;
+		using Equal = equal_dereference;
+		using Hash = hash_dereference;
+
+		T* Alloc() { return new T; }
+		T* Alloc(T&& v) { return new T{std::forward<T>(v)}; }
+		void Free(T* p) { delete p; }
+	};
+
+	template<typename T, typename Allocator>
+	class StdAllocMethod : protected Allocator
+	{
+		using BaseClass = Allocator;
+	public:
+		using PrimitiveType = T;
+		using ElementType = T*;
+
+		using Less = less_dereference;
+		using Equal = equal_dereference;
+		using Hash = hash_dereference;
+
+		T* Alloc() { return BaseClass::allocate(1); }
+		T* Alloc(T&& v) { auto p = BaseClass::allocate(1); *p = T{std::move(v)}; return p; } // construct is deprecated
+		void Free(T* p) { BaseClass::deallocate(p, 1); }
+	};
+
+    /*
+        unique_ptr<~> is too problematic to be contained and manipulated in container-agnostic generic procedure.
+
+            template<typename T>
+            class UniquePtrAllocMethod
+            {
+            public:
+                using PrimitiveType = T;
+                using ElementType = std::unique_ptr<T>;
+
+                using Less = less_dereference;
+                using Equal = equal_dereference;
+                using Hash = hash_dereference;
+
+                ElementType Alloc() { return std::make_unique<T>(); }
+                ElementType Alloc(T&& v) { return std::make_unique<T>(v); }
+                void Free(const ElementType&) { }
+            };
+    */
+
+    template<typename T>
+    class SharedPtrAllocMethod
+    {
+    public:
+        using PrimitiveType = T;
+        using ElementType = std::shared_ptr<T>;
+
+        using Less = less_dereference;
+        using Equal = equal_dereference;
+        using Hash = hash_dereference;
+
+        ElementType Alloc() { return std::make_shared<T>(); }
+        ElementType Alloc(T&& v) { return std::make_shared<T>(v); }
+        void Free(const ElementType&) { }
+    };
+
+	template<typename T>
+	class PlfColonyAllocMethod
+	{
+	private:
+		plf::colony<T> _colony;
+	public:
+		using PrimitiveType = T;
+		using ElementType = typename plf::colony<T>::iterator;
+
+		using Less = less_dereference;
+		using Equal = equal_dereference;
+		using Hash = hash_dereference;
+
+		ElementType Alloc() { return Alloc({}); }
+		ElementType Alloc(T&& v) { return _colony.insert(v); }
+		void Free(ElementType p) { _colony.erase(p); }
+	};
+
+	// The slots are carved out of chunks by bumping a pointer; the freed ones are reused (the most recently freed first)
+	// through a free list threaded through the slots themselves. The chunks are released all at once, along with the arena.
+	// They come from the heap, growing geometrically, or with BenchmarkOptions::ArenaHugePages, from the OS in huge pages
+	// (which pays off only for the large collections, as every arena maps at least one).
+	//
+	template<typename T>
+	class ArenaAllocMethod
+	{
+		union Slot
+		{
+			T Value;
+			Slot* Next;
+		};
+
+		struct Chunk
+		{
+			Slot* Slots;
+			size_t Bytes;
+			size_t MappedBytes; // Non-zero if mapped from the OS.
+		};
+
+		std::vector<Chunk> chunks;
+		Slot* freeList{nullptr};
+		Slot* next{nullptr};
+		Slot* end{nullptr};
+		bool hugePages{benchmarkOptions.ArenaHugePages};
+
+		void Grow()
+		{
+			constexpr size_t firstChunkBytes{4 * 1024};
+			constexpr size_t maxChunkBytes{1024 * 1024};
+
+			auto chunk = Chunk{nullptr, chunks.empty() ? firstChunkBytes : std::min(chunks.back().Bytes * 2, maxChunkBytes), 0};
+			if (hugePages) {
+				chunk.Slots = static_cast<Slot*>(MapHugePages(chunk.Bytes, chunk.MappedBytes));
+				chunk.Bytes = std::max(chunk.Bytes, chunk.MappedBytes);
+			}
+			if (chunk.Slots == nullptr) {
+				chunk.Slots = static_cast<Slot*>(::operator new(chunk.Bytes));
+			}
+			chunks.push_back(chunk);
+
+			next = chunk.Slots;
+			end = next + chunk.Bytes / sizeof(Slot);
+		}
+
+	public:
+		using PrimitiveType = T;
+		using ElementType = T*;
+
+		using Less = less_dereference;
+		using Equal = equal_dereference;
+		using Hash = hash_dereference;
+
+		ArenaAllocMethod() = default;
+		ArenaAllocMethod(ArenaAllocMethod&&) = default;
+
+		~ArenaAllocMethod()
+		{
+			for (const auto& chunk : chunks) {
+				if (chunk.MappedBytes != 0) {
+					UnmapPages(chunk.Slots, chunk.MappedBytes);
+				} else {
+					::operator delete(chunk.Slots);
+				}
+			}
+		}
+
+		T* Alloc() { return Alloc({}); }
+
+		T* Alloc(T&& v)
+		{
+			auto slot = freeList;
+			if (slot != nullptr) {
+				freeList = slot->Next;
+			} else {
+				if (next == end) {
+					Grow();
+				}
+				slot = next++;
+			}
+			return ::new (&slot->Value) T{std::move(v)};
+		}
+
+		void Free(T* p)
+		{
+			const auto slot = reinterpret_cast<Slot*>(p);
+			slot->Next = freeList;
+			freeList = slot;
+		}
+	};
+
+#if defined(FAR_PMR_ALLOCATORS)
+	// The slots come from a memory resource of the kind {Resource} (PmrResources.h) over a buffer of their own, released along
+	// with the method.
+	//
+	template<typename T, typename Resource>
+	class PmrAllocMethod
+	{
+		pmrresource::LentBuffer buffer;
+		pmrresource::BufferedResource<Resource> resource{buffer.Bytes()};
+		std::pmr::polymorphic_allocator<T> allocator{&resource};
+
+	public:
+		using PrimitiveType = T;
+		using ElementType = T*;
+
+		using Less = less_dereference;
+		using Equal = equal_dereference;
+		using Hash = hash_dereference;
+
+		T* Alloc() { return Alloc({}); }
+		T* Alloc(T&& v) { return ::new (static_cast<void*>(allocator.allocate(1))) T{std::move(v)}; }
+
+		void Free(T* p)
+		{
+			p->~T();
+			allocator.deallocate(p, 1);
+		}
+	};
+#endif
+}
+
+template<typename PrimitiveType>
+using SlotAllocMethods = Tag<
+	PrimitiveAllocMethod<PrimitiveType>,
+	slotallocmethod::NewAllocMethod<PrimitiveType>,
+	slotallocmethod::StdAllocMethod<PrimitiveType, std::allocator<PrimitiveType>>,
+	slotallocmethod::SharedPtrAllocMethod<PrimitiveType>,
+	slotallocmethod::PlfColonyAllocMethod<PrimitiveType>,
+	slotallocmethod::ArenaAllocMethod<PrimitiveType>
+#if defined(FAR_PMR_ALLOCATORS)
+	, slotallocmethod::PmrAllocMethod<PrimitiveType, std::pmr::monotonic_buffer_resource>,
+	slotallocmethod::PmrAllocMethod<PrimitiveType, std::pmr::unsynchronized_pool_resource>,
+	slotallocmethod::PmrAllocMethod<PrimitiveType, std::pmr::synchronized_pool_resource>
+#endif
+>;
+
+// Collection allocators of the container-based algorithms. The node-based containers, which allocate (at least) one node
+// per element, are also played with the slab allocator; the others only allocate a few growing arrays, which it would pass
+// on to the heap anyway.
+//
+#if defined(FAR_PMR_ALLOCATORS)
+template<typename ElementType>
+using CollectionAllocators = Tag<
+	std::allocator<ElementType>,
+	pmrresource::PmrAllocator<ElementType, std::pmr::monotonic_buffer_resource>,
+	pmrresource::PmrAllocator<ElementType, std::pmr::unsynchronized_pool_resource>,
+	pmrresource::PmrAllocator<ElementType, std::pmr::synchronized_pool_resource>
+>;
+
+template<typename ElementType>
+using NodeCollectionAllocators = Tag<
+	std::allocator<ElementType>,
+	slaballocator::SlabAllocator<ElementType>,
+	pmrresource::PmrAllocator<ElementType, std::pmr::monotonic_buffer_resource>,
+	pmrresource::PmrAllocator<ElementType, std::pmr::unsynchronized_pool_resource>,
+	pmrresource::PmrAllocator<ElementType, std::pmr::synchronized_pool_resource>
+>;
+#else
+template<typename ElementType>
+using CollectionAllocators = Tag<std::allocator<ElementType>>;
+
+template<typename ElementType>
+using NodeCollectionAllocators = Tag<std::allocator<ElementType>, slaballocator::SlabAllocator<ElementType>>;
+#endif
+
+// Calls {f} with the tag of every primitive type, skipping those too narrow to address {slots} and those not selected.
+//
+template<typename F>
+void ForEachPrimitiveType(int slots, F f)
+{
+	ForEachTag(PrimitiveTypes{},
+		[=] (auto primitiveTag)
+	{
+		using PrimitiveType = typename decltype(primitiveTag)::value_type;
+
+		// Available integer bits must be capable of addressing all the slots.
+		//
+		if (static_cast<uint64_t>(slots) > static_cast<uint64_t>(std::numeric_limits<PrimitiveType>::max())) {
+			return;
+		}
+
+		const auto& primitives = benchmarkOptions.Primitives;
+		if (!primitives.empty() && std::find(std::begin(primitives), std::end(primitives), PrimitiveName(primitiveTag)) == std::end(primitives)) {
+			return;
+		}
+
+		f(primitiveTag);
+	});
+}
+
+// Calls {f} with the tags of every combination of the primitive type, the slot allocation method and the collection allocator
+// of the container-based algorithms, skipping the primitive types too narrow to address {slots} and those not selected.
+//
+template<template<typename> class Allocators = CollectionAllocators, typename F>
+void ForEachSlotAllocMethod(int slots, F f)
+{
+	ForEachPrimitiveType(slots,
+		[=] (auto primitiveTag)
+	{
+		using PrimitiveType = typename decltype(primitiveTag)::value_type;
+
+		ForEachTag(SlotAllocMethods<PrimitiveType>{},
+			[=] (auto slotAllocTag)
+		{
+			using SlotAllocType = typename decltype(slotAllocTag)::value_type;
+			using ElementType = typename SlotAllocType::ElementType;
+
+			ForEachTag(Allocators<ElementType>{},
+				[=] (auto collectionAllocatorTag)
+			{
+				f(slotAllocTag, collectionAllocatorTag);
+			});
+		});
+	});
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+// Pre-generated sequence of slots.
+//
+// Filling the buffer before the measurement removes the cost of the pseudo-random generator from the measured loop;
+// what remains is a sequential read, which the hardware prefetcher hides almost entirely.
+
+using SlotValue = uint32_t;
+
+constexpr size_t hugePageSize{2 * 1024 * 1024};
+
+// Maps at least {bytes} of memory straight from the OS, backed by huge pages if possible. Returns nullptr on failure,
+// otherwise the memory, which is to be released by UnmapPages with the size stored to {mappedBytes}.
+//
+inline void* MapHugePages(size_t bytes, size_t& mappedBytes)
+{
+	bytes = (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+
+#if defined(__linux__)
+	// Explicit huge pages need to be reserved by the administrator; transparent ones are the fallback.
+	//
+	auto p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (p == MAP_FAILED) {
+		p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p != MAP_FAILED) {
+			madvise(p, bytes, MADV_HUGEPAGE);
+		}
+	}
+	if (p != MAP_FAILED) {
+		mappedBytes = bytes;
+		return p;
+	}
+#elif defined(_WIN32)
+	// Requires SeLockMemoryPrivilege, silently falls back to the heap otherwise.
+	//
+	const auto largePageSize = GetLargePageMinimum();
+	if (largePageSize != 0) {
+		const auto largeBytes = (bytes + largePageSize - 1) / largePageSize * largePageSize;
+		auto p = VirtualAlloc(nullptr, largeBytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (p != nullptr) {
+			mappedBytes = largeBytes;
+			return p;
+		}
+	}
+#endif
+	return nullptr;
+}
+
+inline void UnmapPages(void* p, size_t mappedBytes) noexcept
+{
+#if defined(__linux__)
+	munmap(p, mappedBytes);
+#elif defined(_WIN32)
+	VirtualFree(p, 0, MEM_RELEASE);
+#endif
+}
+
+class SlotBuffer
+{
+	SlotValue* data{nullptr};
+	size_t capacity{0};
+	size_t mappedBytes{0}; // Non-zero if the memory comes from the OS directly, rather than from the heap.
+	bool hugePages{false};
+
+	void Release() noexcept
+	{
+		if (mappedBytes != 0) {
+			UnmapPages(data, mappedBytes);
+		} else {
+			delete[] data;
+		}
+		data = nullptr;
+		capacity = 0;
+		mappedBytes = 0;
+	}
+
+	void Allocate(size_t count)
+	{
+		if (hugePages) {
+			data = static_cast<SlotValue*>(MapHugePages(count * sizeof(SlotValue), mappedBytes));
+		}
+
+		if (data == nullptr) {
+			data = new SlotValue[count];
+		}
+		capacity = count;
+	}
+
+public:
+	SlotBuffer() = default;
+	SlotBuffer(const SlotBuffer&) = delete;
+	SlotBuffer& operator=(const SlotBuffer&) = delete;
+	~SlotBuffer() { Release(); }
+
+	void UseHugePages(bool enable)
+	{
+		if (hugePages != enable) {
+			Release();
+			hugePages = enable;
+		}
+	}
+
+	bool IsBackedByOs() const noexcept { return mappedBytes != 0; }
+
+	// Fills the buffer with {count} values drawn from the generator. The memory is reused if large enough.
+	//
+	template<typename RandomGenerator>
+	const SlotValue* Fill(int count, RandomGenerator randomGenerator)
+	{
+		if (capacity < static_cast<size_t>(count)) {
+			Release();
+			Allocate(static_cast<size_t>(count));
+		}
+
+		for (int i{0}; i < count; ++i) {
+			data[i] = static_cast<SlotValue>(randomGenerator());
+		}
+
+		return data;
+	}
+};
+
+// Replays a pre-generated slot sequence. Cheap to copy, as every game takes its generator by value.
+//
+class StreamGenerator
+{
+	const SlotValue* cursor;
+public:
+	explicit StreamGenerator(const SlotValue* slots) : cursor{slots} {}
+	int64_t operator()() { return *cursor++; }
+};
@@ -0,0 +1,349 @@
+#pragma once
+
+// Sorted sequences of slots of a primitive type, searched by engines faster than the branchy std::lower_bound:
+//   BranchlessSearch   binary search of the sorted array by conditional moves, prefetching both of the next probes,
+//   EytzingerSearch    the array laid out as an implicit binary tree in breadth-first order (the next levels are adjacent),
+//   STreeSearch        a static B+-tree-like layout, one cache line per node, whose keys are compared all at once (AVX2).
+// The layouts cannot be updated in place cheaply, so the engine indexes a base array which is only rebuilt once in a while:
+// meanwhile the slots added go to a small sorted delta array, and the slots removed from the base are marked as such.
+// The base is rebuilt once the delta and the marks outgrow the square root of the base, so toggling a slot takes
+// O(sqrt(slots)) amortized, and the sorted sequences can be played far beyond maxSlotsForSequence.
+// The collection has the set-conformant API of SetTag (FindAddRemove.h), i.e. insert(), erase(), size().
+
+namespace sortedsearch
+{
+	inline void Prefetch(const void* p) noexcept
+	{
+#if defined(FAR_SIMD_SEARCH)
+		_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+		__builtin_prefetch(p);
+#endif
+	}
+
+	template<typename T>
+	class BranchlessSearch
+	{
+		std::vector<T> keys;
+
+	public:
+		void Build(const std::vector<T>& sorted)
+		{
+			keys = sorted;
+		}
+
+		// The index of the first of the sorted keys not less than {key}.
+		//
+		size_t LowerBound(T key) const
+		{
+			if (keys.empty()) {
+				return 0;
+			}
+
+			const T* base{keys.data()};
+			size_t length{keys.size()};
+			while (length > 1)
+			{
+				const auto half = length / 2;
+				Prefetch(base + half / 2);
+				Prefetch(base + half + half / 2);
+				base = base[half] < key ? base + half : base;
+				length -= half;
+			}
+			return static_cast<size_t>(base - keys.data()) + (*base < key ? 1 : 0);
+		}
+	};
+
+	template<typename T>
+	class EytzingerSearch
+	{
+		std::vector<T> tree; // 1-based: the children of k are 2k and 2k+1.
+		std::vector<uint32_t> ranks; // The index among the sorted keys of every node.
+
+		size_t Fill(const std::vector<T>& sorted, size_t next, size_t k)
+		{
+			if (k < tree.size())
+			{
+				next = Fill(sorted, next, 2 * k);
+				tree[k] = sorted[next];
+				ranks[k] = static_cast<uint32_t>(next);
+				next = Fill(sorted, next + 1, 2 * k + 1);
+			}
+			return next;
+		}
+
+	public:
+		void Build(const std::vector<T>& sorted)
+		{
+			tree.assign(sorted.size() + 1, T{});
+			ranks.assign(sorted.size() + 1, static_cast<uint32_t>(sorted.size()));
+			Fill(sorted, 0, 1);
+		}
+
+		size_t LowerBound(T key) const
+		{
+			const auto nodes = tree.size();
+			size_t k{1};
+			while (k < nodes)
+			{
+				// The 16th descendants of the node are 4 levels down, within a cache line.
+				//
+				Prefetch(tree.data() + std::min(k * 16, nodes - 1));
+				k = 2 * k + (tree[k] < key ? 1 : 0);
+			}
+			k >>= simdsearch::LowestSetBit(~static_cast<uint64_t>(k)) + 1;
+			return ranks[k];
+		}
+	};
+
+	// The keys ordered as signed integers of the same size, so that the signed SIMD comparisons apply.
+	//
+	template<typename T>
+	using OrderedKey = std::make_signed_t<T>;
+
+	template<typename T>
+	OrderedKey<T> ToOrderedKey(T key) noexcept
+	{
+		using S = OrderedKey<T>;
+		return static_cast<S>(static_cast<S>(key) ^ (std::is_signed<T>::value ? S{0} : std::numeric_limits<S>::min()));
+	}
+
+#if defined(FAR_SIMD_SEARCH)
+	// The byte mask of the lanes of {keys} less than {key}, for the keys of {Size} bytes.
+	//
+	template<size_t Size> struct Avx2Less;
+
+	template<> struct Avx2Less<1>
+	{
+		FAR_TARGET("avx2") static __m256i Broadcast(int8_t key) { return _mm256_set1_epi8(key); }
+		FAR_TARGET("avx2") static uint32_t Mask(__m256i keys, __m256i key) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(key, keys))); }
+	};
+
+	template<> struct Avx2Less<2>
+	{
+		FAR_TARGET("avx2") static __m256i Broadcast(int16_t key) { return _mm256_set1_epi16(key); }
+		FAR_TARGET("avx2") static uint32_t Mask(__m256i keys, __m256i key) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi16(key, keys))); }
+	};
+
+	template<> struct Avx2Less<4>
+	{
+		FAR_TARGET("avx2") static __m256i Broadcast(int32_t key) { return _mm256_set1_epi32(key); }
+		FAR_TARGET("avx2") static uint32_t Mask(__m256i keys, __m256i key) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi32(key, keys))); }
+	};
+
+	template<> struct Avx2Less<8>
+	{
+		FAR_TARGET("avx2") static __m256i Broadcast(int64_t key) { return _mm256_set1_epi64x(key); }
+		FAR_TARGET("avx2") static uint32_t Mask(__m256i keys, __m256i key) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi64(key, keys))); }
+	};
+#endif
+
+	template<typename T>
+	class STreeSearch
+	{
+		using Key = OrderedKey<T>;
+		static constexpr size_t nodeBytes{64};
+		static constexpr size_t keysPerNode{nodeBytes / sizeof(T)};
+
+		// Node k holds the keys [k * keysPerNode, (k + 1) * keysPerNode); child i of node k is k * (keysPerNode + 1) + i + 1.
+		// The nodes past the keys are padded with the greatest key, ranked past the keys.
+		//
+		std::vector<Key> keys;
+		std::vector<uint32_t> ranks;
+		size_t nodes{0};
+		size_t count{0};
+		bool avx2{false};
+
+		static size_t Child(size_t node, size_t i) noexcept
+		{
+			return node * (keysPerNode + 1) + i + 1;
+		}
+
+		size_t Fill(const std::vector<T>& sorted, size_t next, size_t node)
+		{
+			if (node < nodes)
+			{
+				for (size_t i{0}; i < keysPerNode; ++i)
+				{
+					next = Fill(sorted, next, Child(node, i));
+					const auto at = node * keysPerNode + i;
+					if (next < sorted.size()) {
+						keys[at] = ToOrderedKey(sorted[next]);
+						ranks[at] = static_cast<uint32_t>(next++);
+					}
+				}
+				next = Fill(sorted, next, Child(node, keysPerNode));
+			}
+			return next;
+		}
+
+		// The number of the keys of the (sorted) node less than {key}.
+		//
+		static size_t RankScalar(const Key* node, Key key) noexcept
+		{
+			size_t rank{0};
+			for (size_t i{0}; i < keysPerNode; ++i) {
+				rank += node[i] < key ? 1 : 0;
+			}
+			return rank;
+		}
+
+		size_t LowerBoundScalar(Key key) const
+		{
+			auto lowerBound = count;
+			for (size_t node{0}; node < nodes;)
+			{
+				const auto i = RankScalar(keys.data() + node * keysPerNode, key);
+				if (i < keysPerNode) {
+					lowerBound = ranks[node * keysPerNode + i];
+				}
+				node = Child(node, i);
+			}
+			return lowerBound;
+		}
+
+#if defined(FAR_SIMD_SEARCH)
+		// As the node is sorted, the keys less than {key} make a prefix of it.
+		//
+		FAR_TARGET("avx2") size_t LowerBoundAvx2(Key key) const
+		{
+			using Lanes = Avx2Less<sizeof(T)>;
+			const auto broadcast = Lanes::Broadcast(key);
+			auto lowerBound = count;
+			for (size_t node{0}; node < nodes;)
+			{
+				const auto nodeKeys = reinterpret_cast<const __m256i*>(keys.data() + node * keysPerNode);
+				const auto less = static_cast<uint64_t>(Lanes::Mask(_mm256_loadu_si256(nodeKeys), broadcast))
+					| static_cast<uint64_t>(Lanes::Mask(_mm256_loadu_si256(nodeKeys + 1), broadcast)) << 32;
+				const auto i = (~less == 0 ? nodeBytes : simdsearch::LowestSetBit(~less)) / sizeof(T);
+				if (i < keysPerNode) {
+					lowerBound = ranks[node * keysPerNode + i];
+				}
+				node = Child(node, i);
+			}
+			return lowerBound;
+		}
+#endif
+
+	public:
+		void Build(const std::vector<T>& sorted)
+		{
+			count = sorted.size();
+			nodes = (count + keysPerNode - 1) / keysPerNode;
+			keys.assign(nodes * keysPerNode, std::numeric_limits<Key>::max());
+			ranks.assign(nodes * keysPerNode, static_cast<uint32_t>(count));
+			Fill(sorted, 0, 0);
+			avx2 = simdsearch::SupportedInstructionSet() >= simdsearch::InstructionSet::Avx2;
+		}
+
+		size_t LowerBound(T key) const
+		{
+#if defined(FAR_SIMD_SEARCH)
+			if (avx2) {
+				return LowerBoundAvx2(ToOrderedKey(key));
+			}
+#endif
+			return LowerBoundScalar(ToOrderedKey(key));
+		}
+	};
+
+	template<typename T, template<typename> class Engine>
+	class SortedSet
+	{
+		std::vector<T> base; // Sorted; indexed by {engine}.
+		std::vector<uint8_t> removed; // Of the base.
+		std::vector<T> delta; // Sorted; not in the base.
+		size_t removedCount{0};
+		Engine<T> engine;
+
+		// Merges the delta into the base, dropping the removed slots, and indexes the new base.
+		//
+		void Rebuild()
+		{
+			std::vector<T> merged;
+			merged.reserve(base.size() - removedCount + delta.size());
+			auto d = std::begin(delta);
+			for (size_t b{0}; b < base.size(); ++b)
+			{
+				if (removed[b] != 0) {
+					continue;
+				}
+				for (; d != std::end(delta) && *d < base[b]; ++d) {
+					merged.push_back(*d);
+				}
+				merged.push_back(base[b]);
+			}
+			merged.insert(std::end(merged), d, std::end(delta));
+
+			base = std::move(merged);
+			removed.assign(base.size(), 0);
+			delta.clear();
+			removedCount = 0;
+			engine.Build(base);
+		}
+
+		size_t Budget() const
+		{
+			return std::max<size_t>(32, static_cast<size_t>(std::sqrt(static_cast<double>(base.size()))));
+		}
+
+	public:
+		struct Position
+		{
+			bool InDelta;
+			size_t Index;
+		};
+
+		SortedSet()
+		{
+			engine.Build(base);
+		}
+
+		size_t size() const noexcept
+		{
+			return base.size() - removedCount + delta.size();
+		}
+
+		// Adds {key} unless present; returns where it is and whether it was added.
+		//
+		std::pair<Position, bool> insert(T key)
+		{
+			const auto b = engine.LowerBound(key);
+			if (b < base.size() && base[b] == key)
+			{
+				if (removed[b] == 0) {
+					return {{false, b}, false};
+				}
+				removed[b] = 0;
+				--removedCount;
+				return {{false, b}, true};
+			}
+
+			const auto d = std::lower_bound(std::begin(delta), std::end(delta), key);
+			if (d != std::end(delta) && *d == key) {
+				return {{true, static_cast<size_t>(d - std::begin(delta))}, false};
+			}
+
+			const auto index = static_cast<size_t>(d - std::begin(delta));
+			delta.insert(d, key);
+			if (delta.size() + removedCount > Budget()) {
+				Rebuild();
+				return {{false, engine.LowerBound(key)}, true};
+			}
+			return {{true, index}, true};
+		}
+
+		void erase(Position position)
+		{
+			if (position.InDelta) {
+				delta.erase(std::begin(delta) + static_cast<ptrdiff_t>(position.Index));
+				return;
+			}
+
+			removed[position.Index] = 1;
+			if (++removedCount + delta.size() > Budget()) {
+				Rebuild();
+			}
+		}
+	};
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+struct SampleSummary
+{
+	int Count;
+	double Min;
+	double Median;
+	double Mean;
+	double StdDev;
+	double P90;
+	double P99;
+	double Mad; // Median absolute deviation (not scaled to estimate sigma).
+};
+
+// Percentile of an already sorted, non-empty sample, interpolated linearly between the closest ranks.
+//
+inline double SortedPercentile(const std::vector<double>& sorted, double percentile)
+{
+	const auto rank = percentile / 100.0 * static_cast<double>(sorted.size() - 1);
+	const auto lower = static_cast<size_t>(rank);
+	const auto upper = std::min(lower + 1, sorted.size() - 1);
+	return sorted[lower] + (rank - static_cast<double>(lower)) * (sorted[upper] - sorted[lower]);
+}
+
+inline SampleSummary Summarize(std::vector<double> samples)
+{
+	if (samples.empty()) {
+		return {};
+	}
+
+	std::sort(std::begin(samples), std::end(samples));
+
+	const auto count = static_cast<double>(samples.size());
+	double sum{0};
+	for (auto sample : samples) {
+		sum += sample;
+	}
+	const auto mean = sum / count;
+
+	double sumOfSquares{0};
+	for (auto sample : samples) {
+		sumOfSquares += (sample - mean) * (sample - mean);
+	}
+	const auto stdDev = samples.size() > 1 ? std::sqrt(sumOfSquares / (count - 1)) : 0.0;
+
+	const auto median = SortedPercentile(samples, 50);
+	auto deviations{samples};
+	for (auto& deviation : deviations) {
+		deviation = std::abs(deviation - median);
+	}
+	std::sort(std::begin(deviations), std::end(deviations));
+
+	return {
+		static_cast<int>(samples.size()),
+		samples.front(),
+		median,
+		mean,
+		stdDev,
+		SortedPercentile(samples, 90),
+		SortedPercentile(samples, 99),
+		SortedPercentile(deviations, 50)
+	};
+}
+
+// Half-width of the 95% confidence interval of the mean, relative to the mean.
+// Uses the normal approximation, so it is optimistic for a handful of samples - pair it with a minimal repetition count.
+//
+inline double RelativeConfidenceHalfWidth(const SampleSummary& summary)
+{
+	if (summary.Count < 2 || summary.Mean == 0) {
+		return std::numeric_limits<double>::infinity();
+	}
+	return 1.96 * summary.StdDev / std::sqrt(static_cast<double>(summary.Count)) / std::abs(summary.Mean);
+}
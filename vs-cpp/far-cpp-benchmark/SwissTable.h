@@ -0,0 +1,261 @@
+#pragma once
+
+// SwissTable-style open-addressing hash set (as Abseil's flat_hash_set).
+//
+// The slots are flat, and each one has a control byte: empty, deleted (a tombstone), or full with the 7 low bits (H2)
+// of the hash of its slot. The control bytes are probed a group of 16 at a time: a single SSE2 comparison yields the
+// candidates matching H2, so the slots themselves are hardly ever compared in vain. The probing starts at the group
+// selected by the high bits of the hash (H1) and goes on by 1, 2, 3... groups, until a group with an empty slot.
+// Erasing leaves a tombstone only if the group of the slot is full (so a probe might have passed it), which keeps the
+// tombstones rare under the toggling of the FAR workload. Unlike google::dense_hash_set, no key is reserved for
+// the empty and the deleted slots, so InitCollection() has nothing to do.
+// The collection has the set-conformant API of SetTag (FindAddRemove.h), i.e. insert(), erase(), size(), and its probe
+// lengths (in groups) are counted by CountProbeLengths().
+
+namespace swisstable
+{
+	constexpr int8_t emptyControl{-128};
+	constexpr int8_t deletedControl{-2};
+
+	// The bit masks of the slots of a group of control bytes matching a criterion.
+	//
+	struct Group
+	{
+		static constexpr size_t width{16};
+
+#if defined(FAR_SIMD_SEARCH)
+		__m128i Controls;
+
+		explicit Group(const int8_t* controls) noexcept :
+			Controls{_mm_loadu_si128(reinterpret_cast<const __m128i*>(controls))}
+		{ }
+
+		uint32_t Match(int8_t h2) const noexcept
+		{
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), Controls)));
+		}
+
+		// The full slots have the sign bit clear.
+		//
+		uint32_t MatchEmptyOrDeleted() const noexcept
+		{
+			return static_cast<uint32_t>(_mm_movemask_epi8(Controls));
+		}
+#else
+		const int8_t* Controls;
+
+		explicit Group(const int8_t* controls) noexcept :
+			Controls{controls}
+		{ }
+
+		uint32_t Match(int8_t h2) const noexcept
+		{
+			uint32_t mask{0};
+			for (size_t i{0}; i < width; ++i) {
+				mask |= (Controls[i] == h2 ? 1U : 0U) << i;
+			}
+			return mask;
+		}
+
+		uint32_t MatchEmptyOrDeleted() const noexcept
+		{
+			uint32_t mask{0};
+			for (size_t i{0}; i < width; ++i) {
+				mask |= (Controls[i] < 0 ? 1U : 0U) << i;
+			}
+			return mask;
+		}
+#endif
+
+		uint32_t MatchEmpty() const noexcept
+		{
+			return Match(emptyControl);
+		}
+	};
+
+	template<typename Key, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>, typename Allocator = std::allocator<Key>>
+	class SwissSet
+	{
+		using ControlAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<int8_t>;
+
+		static constexpr size_t npos{~size_t{0}};
+
+		std::vector<int8_t, ControlAllocator> controls; // The groups are aligned to their width.
+		std::vector<Key, Allocator> slots;
+		size_t groupMask{0}; // The number of the groups (a power of 2) minus 1.
+		size_t count{0};
+		size_t growthLeft{0}; // The empty slots which may still be filled, keeping the load within 7/8.
+		Hash hasher;
+		Equal equal;
+
+		// The standard hashes of the integers are mostly the identity, so the bits are mixed (as in MurmurHash3 fmix64).
+		//
+		uint64_t HashOf(const Key& key) const
+		{
+			auto h = static_cast<uint64_t>(hasher(key));
+			h ^= h >> 33;
+			h *= 0xFF51AFD7ED558CCDULL;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ULL;
+			h ^= h >> 33;
+			return h;
+		}
+
+		static int8_t H2(uint64_t h) noexcept
+		{
+			return static_cast<int8_t>(h & 0x7F);
+		}
+
+		size_t Capacity() const noexcept
+		{
+			return slots.size();
+		}
+
+		size_t Find(const Key& key, uint64_t h) const
+		{
+			auto group = static_cast<size_t>(h >> 7) & groupMask;
+			for (size_t step{1};; ++step)
+			{
+				const auto base = group * Group::width;
+				const Group controlGroup{controls.data() + base};
+				for (auto mask = controlGroup.Match(H2(h)); mask != 0; mask &= mask - 1)
+				{
+					const auto index = base + simdsearch::LowestSetBit(mask);
+					if (equal(slots[index], key)) {
+						return index;
+					}
+				}
+				if (controlGroup.MatchEmpty() != 0) {
+					return npos;
+				}
+				group = (group + step) & groupMask;
+			}
+		}
+
+		// The first empty or deleted slot on the probe sequence of {h}; there is always an empty one.
+		//
+		size_t FindFree(uint64_t h) const
+		{
+			auto group = static_cast<size_t>(h >> 7) & groupMask;
+			for (size_t step{1};; ++step)
+			{
+				const auto base = group * Group::width;
+				const auto mask = Group{controls.data() + base}.MatchEmptyOrDeleted();
+				if (mask != 0) {
+					return base + simdsearch::LowestSetBit(mask);
+				}
+				group = (group + step) & groupMask;
+			}
+		}
+
+		// Reinserts all the slots into {capacity} slots, dropping the tombstones.
+		//
+		void Rehash(size_t capacity)
+		{
+			auto oldControls = std::move(controls);
+			auto oldSlots = std::move(slots);
+			controls.assign(capacity, emptyControl);
+			slots.assign(capacity, Key{});
+			groupMask = capacity / Group::width - 1;
+			growthLeft = capacity - capacity / 8 - count;
+
+			for (size_t i{0}; i < oldControls.size(); ++i)
+			{
+				if (oldControls[i] >= 0)
+				{
+					const auto h = HashOf(oldSlots[i]);
+					const auto index = FindFree(h);
+					controls[index] = H2(h);
+					slots[index] = std::move(oldSlots[i]);
+				}
+			}
+		}
+
+	public:
+		struct iterator
+		{
+			const Key* Slot;
+			size_t Index;
+
+			const Key& operator*() const noexcept
+			{
+				return *Slot;
+			}
+		};
+
+		SwissSet()
+		{
+			Rehash(Group::width);
+		}
+
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		// Adds {key} unless present; returns where it is and whether it was added.
+		//
+		std::pair<iterator, bool> insert(const Key& key)
+		{
+			const auto h = HashOf(key);
+			const auto found = Find(key, h);
+			if (found != npos) {
+				return {{&slots[found], found}, false};
+			}
+
+			auto index = FindFree(h);
+			if (controls[index] == emptyControl && growthLeft == 0)
+			{
+				// Mostly tombstones: cleaning them up is enough.
+				//
+				const auto capacity = Capacity();
+				Rehash(count * 2 <= capacity - capacity / 8 ? capacity : capacity * 2);
+				index = FindFree(h);
+			}
+
+			if (controls[index] == emptyControl) {
+				--growthLeft;
+			}
+			controls[index] = H2(h);
+			slots[index] = key;
+			++count;
+			return {{&slots[index], index}, true};
+		}
+
+		// The slot becomes empty again if its group has an empty slot, as then no probe has gone past the group.
+		//
+		void erase(iterator position)
+		{
+			const auto index = position.Index;
+			const auto base = index - index % Group::width;
+			slots[index] = Key{};
+			--count;
+			if (Group{controls.data() + base}.MatchEmpty() != 0) {
+				controls[index] = emptyControl;
+				++growthLeft;
+			} else {
+				controls[index] = deletedControl;
+			}
+		}
+
+		// The probe length of a slot is the number of the groups probed before its own.
+		//
+		void CountProbeLengths(ProbeLengthCounts& counts) const
+		{
+			for (size_t index{0}; index < controls.size(); ++index)
+			{
+				if (controls[index] < 0) {
+					continue;
+				}
+
+				const auto h = HashOf(slots[index]);
+				auto group = static_cast<size_t>(h >> 7) & groupMask;
+				size_t probe{0};
+				while (group != index / Group::width) {
+					group = (group + ++probe) & groupMask;
+				}
+				++counts[std::min(probe, counts.size() - 1)];
+			}
+		}
+	};
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+// Timing backends used to measure a single run of the game.
+//
+// Every backend provides Start() and Stop() returning raw ticks, along with the length of a tick in nanoseconds.
+// The backend is selected at runtime, but the dispatch happens only around the measured run, never inside of it.
+
+namespace timer
+{
+	struct SteadyClock
+	{
+		static constexpr const char* Name() noexcept { return "steady_clock"; }
+
+		static int64_t Now() noexcept { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+		static int64_t Start() noexcept { return Now(); }
+		static int64_t Stop() noexcept { return Now(); }
+
+		static double NsPerTick() noexcept
+		{
+			using Period = std::chrono::steady_clock::period;
+			return 1e9 * static_cast<double>(Period::num) / static_cast<double>(Period::den);
+		}
+	};
+
+#if defined(__linux__)
+	// Not slewed by NTP, unlike CLOCK_MONOTONIC which steady_clock usually maps to.
+	//
+	struct MonotonicRawClock
+	{
+		static constexpr const char* Name() noexcept { return "monotonic_raw"; }
+
+		static int64_t Now() noexcept
+		{
+			timespec ts;
+			clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+			return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+		}
+
+		static int64_t Start() noexcept { return Now(); }
+		static int64_t Stop() noexcept { return Now(); }
+		static double NsPerTick() noexcept { return 1.0; }
+	};
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+	// Time Stamp Counter. Assumes invariant TSC, which every x86-64 server of the last decade has.
+	//
+	// RDTSC alone may be reordered with the surrounding instructions, so the reads are fenced:
+	// LFENCE before the first read keeps the preceding code out of the measured region, RDTSCP waits for the measured
+	// code to retire, and the trailing LFENCE keeps the following code from starting before the counter is read.
+	//
+	struct TscClock
+	{
+		static constexpr const char* Name() noexcept { return "tsc"; }
+
+		static int64_t Start() noexcept
+		{
+			_mm_lfence();
+			const auto ticks = __rdtsc();
+			_mm_lfence();
+			return static_cast<int64_t>(ticks);
+		}
+
+		static int64_t Stop() noexcept
+		{
+			unsigned int aux;
+			const auto ticks = __rdtscp(&aux);
+			_mm_lfence();
+			return static_cast<int64_t>(ticks);
+		}
+
+		// Calibrated once against steady_clock over a ~50ms busy-wait.
+		//
+		static double NsPerTick()
+		{
+			static const double nsPerTick = [] {
+				namespace chrono = std::chrono;
+
+				const auto time0 = chrono::steady_clock::now();
+				const auto ticks0 = Start();
+				auto time1 = time0;
+				while (time1 - time0 < chrono::milliseconds{50}) {
+					time1 = chrono::steady_clock::now();
+				}
+				const auto ticks1 = Stop();
+
+				const auto elapsedNs = chrono::duration_cast<chrono::nanoseconds>(time1 - time0).count();
+				return static_cast<double>(elapsedNs) / static_cast<double>(ticks1 - ticks0);
+			}();
+			return nsPerTick;
+		}
+	};
+#endif
+
+	class Timer
+	{
+		const char* name;
+		int64_t (*start)() noexcept;
+		int64_t (*stop)() noexcept;
+		double nsPerTick;
+
+	public:
+		template<typename Clock>
+		explicit Timer(Clock) : name{Clock::Name()}, start{&Clock::Start}, stop{&Clock::Stop}, nsPerTick{Clock::NsPerTick()} {}
+
+		const char* Name() const noexcept { return name; }
+		double NsPerTick() const noexcept { return nsPerTick; }
+
+		int64_t Start() const noexcept { return start(); }
+		int64_t Stop() const noexcept { return stop(); }
+
+		double ElapsedNs(int64_t ticks0, int64_t ticks1) const noexcept { return static_cast<double>(ticks1 - ticks0) * nsPerTick; }
+	};
+
+	inline std::vector<std::string> AvailableTimers()
+	{
+		return {
+			SteadyClock::Name(),
+#if defined(__linux__)
+			MonotonicRawClock::Name(),
+#endif
+#if defined(_M_X64) || defined(__x86_64__)
+			TscClock::Name(),
+#endif
+		};
+	}
+
+	// Throws std::invalid_argument if the backend is unknown or not supported on this platform.
+	//
+	inline Timer MakeTimer(const std::string& name)
+	{
+		if (name == SteadyClock::Name()) {
+			return Timer{SteadyClock{}};
+		}
+#if defined(__linux__)
+		if (name == MonotonicRawClock::Name()) {
+			return Timer{MonotonicRawClock{}};
+		}
+#endif
+#if defined(_M_X64) || defined(__x86_64__)
+		if (name == TscClock::Name()) {
+			return Timer{TscClock{}};
+		}
+#endif
+		throw std::invalid_argument{"Unknown timer: " + name};
+	}
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+// Binary trace of slots, recorded from a generator (or captured from a real service) and replayed by the game.
+//
+// Layout (little-endian):
+//   header: "FARTRACE" | uint32 version | uint32 slots | uint64 count
+//   body:   {count} values, each encoded as the zigzag-mapped difference from the previous value (starting at 0),
+//           stored as a LEB128 varint - a sequence of 7-bit groups, least significant first, the high bit marking continuation.
+//
+// {slots} is the size of the key space the trace was recorded for: every value lies within the range from 1 to {slots}-1.
+// The trace is memory-mapped for the replay, so it does not need to fit in RAM.
+
+namespace trace
+{
+	constexpr char magic[8]{'F', 'A', 'R', 'T', 'R', 'A', 'C', 'E'};
+	constexpr uint32_t version{1};
+
+	struct Header
+	{
+		char Magic[8];
+		uint32_t Version;
+		uint32_t Slots;
+		uint64_t Count;
+	};
+
+	static_assert(sizeof(Header) == 24, "The header must not be padded");
+
+	inline uint64_t ZigZagEncode(int64_t value) noexcept
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	inline int64_t ZigZagDecode(uint64_t value) noexcept
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	class TraceWriter
+	{
+		std::ofstream file;
+		Header header;
+		int64_t previous{0};
+		char buffer[10];
+
+	public:
+		TraceWriter(const std::string& path, int slots) :
+			file{path, std::ios::binary | std::ios::trunc},
+			header{{}, version, static_cast<uint32_t>(slots), 0}
+		{
+			if (!file) {
+				throw std::runtime_error{"Cannot create trace: " + path};
+			}
+			std::copy(std::begin(magic), std::end(magic), header.Magic);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		}
+
+		void Append(int64_t value)
+		{
+			auto encoded = ZigZagEncode(value - previous);
+			previous = value;
+
+			int length{0};
+			while (encoded >= 0x80) {
+				buffer[length++] = static_cast<char>(encoded | 0x80);
+				encoded >>= 7;
+			}
+			buffer[length++] = static_cast<char>(encoded);
+
+			file.write(buffer, length);
+			++header.Count;
+		}
+
+		// Patches the number of values into the header.
+		//
+		void Close()
+		{
+			file.seekp(0);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.close();
+			if (!file) {
+				throw std::runtime_error{"Cannot write trace"};
+			}
+		}
+	};
+
+	// Writes {count} values of the generator to a new trace.
+	//
+	template<typename RandomGenerator>
+	void Record(const std::string& path, int slots, int64_t count, RandomGenerator randomGenerator)
+	{
+		auto writer = TraceWriter{path, slots};
+		for (int64_t i{0}; i < count; ++i) {
+			writer.Append(randomGenerator());
+		}
+		writer.Close();
+	}
+
+	// Read-only mapping of a whole trace file.
+	//
+	class MappedTrace
+	{
+		const uint8_t* data{nullptr};
+		size_t size{0};
+		Header header{};
+#if defined(_WIN32)
+		HANDLE fileHandle{INVALID_HANDLE_VALUE};
+		HANDLE mappingHandle{nullptr};
+#endif
+
+	public:
+		explicit MappedTrace(const std::string& path)
+		{
+#if defined(__linux__)
+			const auto fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				throw std::runtime_error{"Cannot open trace: " + path};
+			}
+			struct stat status;
+			if (fstat(fd, &status) == 0 && status.st_size > 0) {
+				size = static_cast<size_t>(status.st_size);
+				auto p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p != MAP_FAILED) {
+					data = static_cast<const uint8_t*>(p);
+					madvise(p, size, MADV_SEQUENTIAL);
+				}
+			}
+			close(fd);
+#elif defined(_WIN32)
+			fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (fileHandle == INVALID_HANDLE_VALUE) {
+				throw std::runtime_error{"Cannot open trace: " + path};
+			}
+			LARGE_INTEGER fileSize;
+			if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0) {
+				size = static_cast<size_t>(fileSize.QuadPart);
+				mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mappingHandle != nullptr) {
+					data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+				}
+			}
+#endif
+			if (data == nullptr) {
+				Release();
+				throw std::runtime_error{"Cannot map trace: " + path};
+			}
+
+			if (size < sizeof(Header)) {
+				Release();
+				throw std::runtime_error{"Truncated trace: " + path};
+			}
+			std::copy(data, data + sizeof(Header), reinterpret_cast<uint8_t*>(&header));
+			if (!std::equal(std::begin(magic), std::end(magic), header.Magic) || header.Version != version) {
+				Release();
+				throw std::runtime_error{"Not a trace (or an unsupported version): " + path};
+			}
+			Validate(path);
+		}
+
+		MappedTrace(const MappedTrace&) = delete;
+		MappedTrace& operator=(const MappedTrace&) = delete;
+		~MappedTrace() { Release(); }
+
+		int Slots() const noexcept { return static_cast<int>(header.Slots); }
+		int64_t Count() const noexcept { return static_cast<int64_t>(header.Count); }
+		const uint8_t* Values() const noexcept { return data + sizeof(Header); }
+
+	private:
+		// Walks the whole body once, so that the replay can decode it unchecked: exactly {count} well-formed varints
+		// (of at most 10 bytes, fitting in 64 bits), every value within the range of the slots.
+		//
+		void Validate(const std::string& path)
+		{
+			const auto corrupt = [&] (const char* what) {
+				Release();
+				throw std::runtime_error{"Corrupt trace (" + std::string{what} + "): " + path};
+			};
+
+			if (header.Slots < 2 || header.Slots > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
+				corrupt("slots out of range");
+			}
+
+			auto cursor = Values();
+			const auto end = data + size;
+			int64_t previous{0};
+			for (uint64_t i{0}; i < header.Count; ++i)
+			{
+				uint64_t encoded{0};
+				for (int shift{0};; shift += 7)
+				{
+					if (cursor == end) {
+						corrupt("truncated");
+					}
+					const auto byte = *cursor++;
+					if (shift == 63 && byte > 1) {
+						corrupt("varint overflow");
+					}
+					encoded |= static_cast<uint64_t>(byte & 0x7F) << shift;
+					if (byte < 0x80) {
+						break;
+					}
+				}
+
+				// Wrapping around, as a corrupt difference may overflow.
+				//
+				previous = static_cast<int64_t>(static_cast<uint64_t>(previous) + static_cast<uint64_t>(ZigZagDecode(encoded)));
+				if (previous < 1 || previous >= static_cast<int64_t>(header.Slots)) {
+					corrupt("value out of range");
+				}
+			}
+			if (cursor != end) {
+				corrupt("trailing bytes");
+			}
+		}
+
+		void Release() noexcept
+		{
+#if defined(__linux__)
+			if (data != nullptr) {
+				munmap(const_cast<uint8_t*>(data), size);
+			}
+#elif defined(_WIN32)
+			if (data != nullptr) {
+				UnmapViewOfFile(data);
+			}
+			if (mappingHandle != nullptr) {
+				CloseHandle(mappingHandle);
+			}
+			if (fileHandle != INVALID_HANDLE_VALUE) {
+				CloseHandle(fileHandle);
+			}
+			mappingHandle = nullptr;
+			fileHandle = INVALID_HANDLE_VALUE;
+#endif
+			data = nullptr;
+		}
+	};
+}
+
+// Replays a trace, decoding the values on the fly. Cheap to copy, as every game takes its generator by value.
+// The body was validated when mapped, so it is decoded unchecked. Playing more turns than the trace holds is undefined -
+// the driver caps the turns at Count().
+//
+class TraceReplayGenerator
+{
+	const uint8_t* cursor;
+	int64_t previous{0};
+
+public:
+	explicit TraceReplayGenerator(const trace::MappedTrace& mappedTrace) : cursor{mappedTrace.Values()} {}
+
+	int64_t operator()()
+	{
+		uint64_t encoded{*cursor++};
+		if (encoded >= 0x80)
+		{
+			encoded &= 0x7F;
+			int shift{7};
+			uint8_t byte;
+			do {
+				byte = *cursor++;
+				encoded |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				shift += 7;
+			} while (byte >= 0x80);
+		}
+
+		previous += trace::ZigZagDecode(encoded);
+		return previous;
+	}
+};
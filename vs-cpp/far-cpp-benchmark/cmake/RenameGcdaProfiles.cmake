@@ -0,0 +1,13 @@
+# GCC names the profile of every object after the object's path (with '#' for the separators), so the profile collected by
+# one target is not found by another. Renames the profiles in PROFILE_DIRECTORY from the FROM target's objects to the TO target's.
+#
+# Usage: cmake -DPROFILE_DIRECTORY=... -DFROM=... -DTO=... -P RenameGcdaProfiles.cmake
+
+file(GLOB profiles "${PROFILE_DIRECTORY}/*.gcda")
+foreach(profile IN LISTS profiles)
+	get_filename_component(name "${profile}" NAME)
+	string(REPLACE "#${FROM}.dir#" "#${TO}.dir#" renamed "${name}")
+	if(NOT renamed STREQUAL name)
+		file(RENAME "${profile}" "${PROFILE_DIRECTORY}/${renamed}")
+	endif()
+endforeach()